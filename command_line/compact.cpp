@@ -0,0 +1,68 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "compact.h"
+#include "commoncommandlinefunctions.h"
+
+#include "graph/assemblygraph.h"
+#include "graph/gfawriter.h"
+
+#include "program/globals.h"
+
+#include <CLI/CLI.hpp>
+
+CLI::App *addCompactSubcommand(CLI::App &app, CompactCmd &cmd) {
+    auto *compact = app.add_subcommand("compact", "Merge all non-branching paths of a graph");
+    compact->add_option("<inputgraph>", cmd.m_graph, "A graph file of any type supported by Bandage")
+            ->required()->check(CLI::ExistingFile);
+    compact->add_option("<outputgraph>", cmd.m_out, "The filename for the GFA graph to be made (if it does not end in '.gfa', that extension will be added)")
+            ->required();
+
+    compact->footer("Bandage compact takes an input graph, merges every simple non-branching path into a single node and saves the result in GFA format.\n"
+                    "Paths and walks through the merged nodes are rewritten to use the merged nodes.\n"
+                    "This is the same operation as 'Merge all possible nodes' in the GUI.");
+
+    return compact;
+}
+
+int handleCompactCmd(QApplication *app,
+                     const CLI::App &cli, const CompactCmd &cmd) {
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString outputFilename = QString::fromStdString(cmd.m_out.generic_string());
+    if (!outputFilename.endsWith(".gfa"))
+        outputFilename += ".gfa";
+
+    QString inputFilename = QString::fromStdString(cmd.m_graph.generic_string());
+    if (!g_assemblyGraph->loadGraphFromFile(inputFilename)) {
+        outputText("Bandage-NG error: could not load " + inputFilename, &err);
+        return 1;
+    }
+
+    int merges = g_assemblyGraph->mergeAllPossible();
+
+    if (!gfa::saveEntireGraph(outputFilename, *g_assemblyGraph)) {
+        err << "Bandage was unable to save the graph file." << Qt::endl;
+        return 1;
+    }
+
+    out << "Merged " << merges << " non-branching paths" << Qt::endl;
+
+    return 0;
+}
@@ -19,7 +19,9 @@
 #include "image.h"
 #include "commoncommandlinefunctions.h"
 
+#include "graph/annotationsmanager.h"
 #include "graph/assemblygraph.h"
+#include "graph/io.h"
 
 #include "graphsearch/blast/blastsearch.h"
 
@@ -32,9 +34,16 @@
 #include "ui/bandagegraphicsscene.h"
 #include "ui/bandagegraphicsview.h"
 
-#include <vector>
+#include <QDir>
+#include <QFile>
 #include <QPainter>
 #include <QSvgGenerator>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
 
 #include <CLI/CLI.hpp>
 
@@ -42,33 +51,123 @@ CLI::App *addImageSubcommand(CLI::App &app, ImageCmd &cmd) {
     auto *image = app.add_subcommand("image", "Generate an image file of a graph");
     image->add_option("<graph>", cmd.m_graph, "A graph file of any type supported by Bandage")
             ->required()->check(CLI::ExistingFile);
-    image->add_option("<output_file>", cmd.m_image, "The image file to be created (must end in '.jpg', '.png' or '.svg')")
+    image->add_option("<output_file>", cmd.m_image, "The image file to be created (must end in '.jpg', '.png', '.svg' or '.dzi')")
             ->required();
     image->add_option("--height", cmd.m_height, "Image height")
-            ->default_val(cmd.m_height)->check(CLI::Range(1, 32767));
+            ->default_val(cmd.m_height)->check(CLI::Range(1u, MaxTiledImageSize));
     image->add_option("--width", cmd.m_width, "Image width")
-            ->check(CLI::Range(1, 32767));
+            ->check(CLI::Range(1u, MaxTiledImageSize));
+    image->add_option("--tilesize", cmd.m_tileSize, "Tile size for '.dzi' image pyramids")
+            ->default_val(cmd.m_tileSize)->check(CLI::Range(64, 4096));
     image->add_option("--color", cmd.m_color, "csv file with 2 columns: first the node name second the node color")
             ->check(CLI::ExistingFile);
+    image->add_option("--bed", cmd.m_bed, "BED file (.bed or .bed.gz) with features to draw on the nodes")
+            ->check(CLI::ExistingFile);
 
-    image->footer("If only height or width is set, the other will be determined automatically. If both are set, the image will be exactly that size");
+    image->footer("If only height or width is set, the other will be determined automatically. If both are set, the image will be exactly that size. "
+                  "A '.dzi' output is written as a Deep Zoom pyramid of PNG tiles, so its size is not limited by memory. "
+                  "Only features on the drawn nodes are loaded from the BED file; for a bgzip-compressed file with a tabix index "
+                  "next to it only the corresponding parts of the file are read");
 
     return image;
 }
 
+// Renders the scene as a Deep Zoom (DZI) image pyramid: an XML descriptor and a
+// <name>_files directory with one subdirectory of PNG tiles per zoom level.
+// Tiles are rendered one at a time, so memory use does not depend on the output
+// resolution. The scene can only be rendered from this thread, but PNG encoding
+// is the dominant cost for large exports and is done on the thread pool.
+static bool renderImagePyramid(QGraphicsScene &scene, const std::filesystem::path &descriptor,
+                               unsigned width, unsigned height, unsigned tileSize) {
+    std::filesystem::path filesDir = descriptor.parent_path() / (descriptor.stem().string() + "_files");
+    QRectF sceneRect = scene.sceneRect();
+
+    unsigned maxLevel = 0;
+    while ((1u << maxLevel) < std::max(width, height))
+        ++maxLevel;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    size_t maxPendingTiles = 2 * size_t(std::max(1, pool->maxThreadCount()));
+    std::deque<QFuture<bool>> pendingTiles;
+    bool success = true;
+    auto waitForTile = [&]() {
+        success &= pendingTiles.front().result();
+        pendingTiles.pop_front();
+    };
+
+    for (unsigned level = 0; level <= maxLevel && success; ++level) {
+        unsigned shift = maxLevel - level;
+        unsigned levelWidth = std::max(1u, (width + (1u << shift) - 1) >> shift);
+        unsigned levelHeight = std::max(1u, (height + (1u << shift) - 1) >> shift);
+
+        QString levelDir = QString::fromStdString((filesDir / std::to_string(level)).generic_string());
+        if (!QDir().mkpath(levelDir))
+            return false;
+
+        // Keep the aspect ratio and centre the scene, as QGraphicsScene::render does
+        double scale = std::min(levelWidth / sceneRect.width(), levelHeight / sceneRect.height());
+        QPointF origin(sceneRect.left() - (levelWidth - sceneRect.width() * scale) / 2.0 / scale,
+                       sceneRect.top() - (levelHeight - sceneRect.height() * scale) / 2.0 / scale);
+
+        for (unsigned y = 0; y < levelHeight && success; y += tileSize) {
+            for (unsigned x = 0; x < levelWidth; x += tileSize) {
+                unsigned tileWidth = std::min(tileSize, levelWidth - x);
+                unsigned tileHeight = std::min(tileSize, levelHeight - y);
+
+                QImage tile(tileWidth, tileHeight, QImage::Format_ARGB32);
+                tile.fill(Qt::white);
+                {
+                    QPainter painter(&tile);
+                    painter.setRenderHint(QPainter::Antialiasing);
+                    painter.setRenderHint(QPainter::TextAntialiasing);
+                    QRectF source(origin.x() + x / scale, origin.y() + y / scale,
+                                  tileWidth / scale, tileHeight / scale);
+                    scene.render(&painter, QRectF(0, 0, tileWidth, tileHeight), source,
+                                 Qt::IgnoreAspectRatio);
+                }
+
+                QString fileName = levelDir + QString("/%1_%2.png").arg(x / tileSize).arg(y / tileSize);
+                if (pendingTiles.size() >= maxPendingTiles)
+                    waitForTile();
+                pendingTiles.push_back(QtConcurrent::run(pool, [tile, fileName]() {
+                    return tile.save(fileName);
+                }));
+            }
+        }
+    }
+
+    while (!pendingTiles.empty())
+        waitForTile();
+    if (!success)
+        return false;
+
+    QFile file(QString::fromStdString(descriptor.generic_string()));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream out(&file);
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        << "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" Format=\"png\" Overlap=\"0\" TileSize=\"" << tileSize << "\">\n"
+        << "  <Size Width=\"" << width << "\" Height=\"" << height << "\"/>\n"
+        << "</Image>\n";
+    out.flush();
+
+    return out.status() == QTextStream::Ok;
+}
+
 int handleImageCmd(QApplication *app,
                    const CLI::App &cli, const ImageCmd &cmd) {
     auto imageFileExtension = cmd.m_image.extension();
-    bool pixelImage;
+    bool pixelImage = false, tiledImage = false;
 
     QTextStream out(stdout);
     QTextStream err(stderr);
     if (imageFileExtension == ".png" || imageFileExtension == ".jpg")
         pixelImage = true;
-    else if (imageFileExtension == ".svg")
-        pixelImage = false;
-    else {
-        outputText("Bandage-NG error: the output filename must end in .png, .jpg or .svg", &err);
+    else if (imageFileExtension == ".dzi")
+        tiledImage = true;
+    else if (imageFileExtension != ".svg") {
+        outputText("Bandage-NG error: the output filename must end in .png, .jpg, .svg or .dzi", &err);
         return 1;
     }
 
@@ -142,15 +241,33 @@ int handleImageCmd(QApplication *app,
 
 
     g_assemblyGraph->markNodesToDraw(scope, startingNodes);
+
+    if (!cmd.m_bed.empty()) {
+        QString filename = QString::fromStdString(cmd.m_bed.generic_string());
+        auto &group = g_annotationsManager->createBedAnnotationGroup(g_settings->bedAnnotationGroupName);
+        try {
+            if (!io::loadBEDAnnotations(*g_assemblyGraph, filename, group.annotations, true)) {
+                err << "Bandage-NG error: could not load " << filename << Qt::endl;
+                return 1;
+            }
+        } catch (std::exception &e) {
+            err << "Bandage-NG error: could not load " << filename << ": " << e.what() << Qt::endl;
+            return 1;
+        }
+
+        // Show all views of the features
+        for (ViewId view = 0; view < ViewId(group.views.size()); ++view)
+            g_settings->annotationsSettings[group.id].viewsToShow.insert(view);
+    }
     BandageGraphicsScene scene;
     {
         GraphLayoutStorage layout =
-                GraphLayoutWorker(g_settings->graphLayoutQuality,
+                GraphLayoutWorker(g_settings->graphLayoutAlgorithm,
+                                  g_settings->graphLayoutQuality,
                                   g_settings->linearLayout,
                                   g_settings->componentSeparation).layoutGraph(*g_assemblyGraph);
 
         scene.addGraphicsItemsToScene(*g_assemblyGraph, layout);
-        scene.setSceneRectangle();
     }
     double sceneRectAspectRatio = scene.sceneRect().width() / scene.sceneRect().height();
 
@@ -166,9 +283,17 @@ int handleImageCmd(QApplication *app,
     else if (height == 0 && width > 0)
         height = width / sceneRectAspectRatio;
 
+    if (pixelImage && std::max(width, height) > MaxImageSize) {
+        outputText("Bandage-NG error: .png and .jpg images are limited to " + QString::number(MaxImageSize) +
+                   " pixels per side, use a .dzi output for larger images", &err);
+        return 1;
+    }
+
     bool success = true;
     QPainter painter;
-    if (pixelImage) {
+    if (tiledImage) {
+        success = renderImagePyramid(scene, cmd.m_image, width, height, cmd.m_tileSize);
+    } else if (pixelImage) {
         QImage image(width, height, QImage::Format_ARGB32);
         image.fill(Qt::white);
         painter.begin(&image);
@@ -24,12 +24,18 @@ namespace CLI {
     class App;
 };
 
+// Largest side of an image rendered in one piece, and of a tiled image pyramid
+constexpr unsigned MaxImageSize = 32767;
+constexpr unsigned MaxTiledImageSize = 1u << 24;
+
 struct ImageCmd {
     std::filesystem::path m_graph;
     std::filesystem::path m_image;
     unsigned m_height = 1000;
     unsigned m_width = 0;
+    unsigned m_tileSize = 256;
     std::filesystem::path m_color;
+    std::filesystem::path m_bed;
 };
 
 CLI::App *addImageSubcommand(CLI::App &app, ImageCmd &cmd);
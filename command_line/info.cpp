@@ -19,6 +19,7 @@
 
 #include "commoncommandlinefunctions.h"
 #include "graph/assemblygraph.h"
+#include "graph/graphstats.h"
 #include "program/settings.h"
 
 #include <CLI/CLI.hpp>
@@ -49,7 +50,10 @@ CLI::App *addInfoSubcommand(CLI::App &app, InfoCmd &cmd) {
         "  * Upper quartile node: The median node length for the longer half of the nodes.\n"
         "  * Longest node: The length of the longest node in the graph.\n"
         "  * Median depth: The median depth of the graph, by base.\n"
-        "  * Estimated sequence length: An estimate of the total number of bases in the original sequence, calculated by multiplying each node's length (minus overlaps) by its depth relative to the median.");
+        "  * Estimated sequence length: An estimate of the total number of bases in the original sequence, calculated by multiplying each node's length (minus overlaps) by its depth relative to the median.\n"
+        "  * Component size distribution: Comma-separated pairs of component size (in nodes) and the number of components of that size (only included in the tab-delimited output).\n"
+        "  * Load throughput: The speed at which the graph file was parsed (only reported for GFA graphs and not included in the tab-delimited output).\n"
+        "  * Packed sequence unshared / stored: The memory needed for the 2-bit packed node sequences if every node stored its own copy, and the memory actually used with reverse complement nodes sharing the sequence of their positive node (not included in the tab-delimited output).");
 
     return info;
 }
@@ -65,73 +69,64 @@ int handleInfoCmd(QApplication *app,
         return 1;
     }
 
-    int nodeCount = g_assemblyGraph->m_nodeCount;
-    int edgeCount = g_assemblyGraph->m_edgeCount;
-    QPair<int, int> overlapRange = g_assemblyGraph->getOverlapRange();
-    int smallestOverlap = overlapRange.first;
-    int largestOverlap = overlapRange.second;
-    int totalLength = g_assemblyGraph->m_totalLength;
-    int totalLengthNoOverlaps = g_assemblyGraph->getTotalLengthMinusEdgeOverlaps();
-    int deadEnds = g_assemblyGraph->getDeadEndCount();
-    double percentageDeadEnds = 100.0 * double(deadEnds) / (2 * nodeCount);
-
-    int n50 = 0;
-    int shortestNode = 0;
-    int firstQuartile = 0;
-    int median = 0;
-    int thirdQuartile = 0;
-    int longestNode = 0;
-    g_assemblyGraph->getNodeStats(&n50, &shortestNode, &firstQuartile, &median, &thirdQuartile, &longestNode);
-
-    int componentCount = 0;
-    int largestComponentLength = 0;
-    g_assemblyGraph->getGraphComponentCountAndLargestComponentSize(&componentCount, &largestComponentLength);
-    long long totalLengthOrphanedNodes = g_assemblyGraph->getTotalLengthOrphanedNodes();
-
-    double medianDepthByBase = g_assemblyGraph->getMedianDepthByBase();
-    long long estimatedSequenceLength = g_assemblyGraph->getEstimatedSequenceLength(medianDepthByBase);
+    graph::GraphStats stats = graph::computeGraphStats(*g_assemblyGraph);
+
+    QString componentSizes;
+    for (auto [size, count] : stats.componentSizes) {
+        if (!componentSizes.isEmpty())
+            componentSizes += ",";
+        componentSizes += QString::number(size) + ":" + QString::number(count);
+    }
 
     if (cmd.m_tsv) {
         out << cmd.m_graph.c_str() << "\t"
-            << nodeCount << "\t"
-            << edgeCount << "\t"
-            << smallestOverlap << "\t"
-            << largestOverlap << "\t"
-            << totalLength << "\t"
-            << totalLengthNoOverlaps << "\t"
-            << deadEnds << "\t"
-            << percentageDeadEnds << "%\t"
-            << componentCount << "\t"
-            << largestComponentLength << "\t"
-            << totalLengthOrphanedNodes << "\t"
-            << n50 << "\t"
-            << shortestNode << "\t"
-            << firstQuartile << "\t"
-            << median << "\t"
-            << thirdQuartile << "\t"
-            << longestNode << "\t"
-            << medianDepthByBase << "\t"
-            << estimatedSequenceLength << "\n";
+            << g_assemblyGraph->m_nodeCount << "\t"
+            << g_assemblyGraph->m_edgeCount << "\t"
+            << stats.smallestOverlap << "\t"
+            << stats.largestOverlap << "\t"
+            << g_assemblyGraph->m_totalLength << "\t"
+            << stats.totalLengthNoOverlaps << "\t"
+            << stats.deadEnds << "\t"
+            << stats.percentageDeadEnds << "%\t"
+            << stats.componentCount << "\t"
+            << stats.largestComponentLength << "\t"
+            << stats.totalLengthOrphanedNodes << "\t"
+            << stats.n50 << "\t"
+            << stats.shortestNode << "\t"
+            << stats.firstQuartile << "\t"
+            << stats.median << "\t"
+            << stats.thirdQuartile << "\t"
+            << stats.longestNode << "\t"
+            << stats.medianDepthByBase << "\t"
+            << stats.estimatedSequenceLength << "\t"
+            << componentSizes << "\n";
     } else {
-        out << "Node count:                       " << nodeCount << "\n"
-            << "Edge count:                       " << edgeCount << "\n"
-            << "Smallest edge overlap (bp):       " << smallestOverlap << "\n"
-            << "Largest edge overlap (bp):        " << largestOverlap << "\n"
-            << "Total length (bp):                " << totalLength << "\n"
-            << "Total length no overlaps (bp):    " << totalLengthNoOverlaps << "\n"
-            << "Dead ends:                        " << deadEnds << "\n"
-            << "Percentage dead ends:             " << percentageDeadEnds << "%\n"
-            << "Connected components:             " << componentCount << "\n"
-            << "Largest component (bp):           " << largestComponentLength << "\n"
-            << "Total length orphaned nodes (bp): " << totalLengthOrphanedNodes << "\n"
-            << "N50 (bp):                         " << n50 << "\n"
-            << "Shortest node (bp):               " << shortestNode << "\n"
-            << "Lower quartile node (bp):         " << firstQuartile << "\n"
-            << "Median node (bp):                 " << median << "\n"
-            << "Upper quartile node (bp):         " << thirdQuartile << "\n"
-            << "Longest node (bp):                " << longestNode << "\n"
-            << "Median depth:                     " << medianDepthByBase << "\n"
-            << "Estimated sequence length (bp):   " << estimatedSequenceLength << "\n";
+        out << "Node count:                       " << g_assemblyGraph->m_nodeCount << "\n"
+            << "Edge count:                       " << g_assemblyGraph->m_edgeCount << "\n"
+            << "Smallest edge overlap (bp):       " << stats.smallestOverlap << "\n"
+            << "Largest edge overlap (bp):        " << stats.largestOverlap << "\n"
+            << "Total length (bp):                " << g_assemblyGraph->m_totalLength << "\n"
+            << "Total length no overlaps (bp):    " << stats.totalLengthNoOverlaps << "\n"
+            << "Dead ends:                        " << stats.deadEnds << "\n"
+            << "Percentage dead ends:             " << stats.percentageDeadEnds << "%\n"
+            << "Connected components:             " << stats.componentCount << "\n"
+            << "Largest component (bp):           " << stats.largestComponentLength << "\n"
+            << "Total length orphaned nodes (bp): " << stats.totalLengthOrphanedNodes << "\n"
+            << "N50 (bp):                         " << stats.n50 << "\n"
+            << "Shortest node (bp):               " << stats.shortestNode << "\n"
+            << "Lower quartile node (bp):         " << stats.firstQuartile << "\n"
+            << "Median node (bp):                 " << stats.median << "\n"
+            << "Upper quartile node (bp):         " << stats.thirdQuartile << "\n"
+            << "Longest node (bp):                " << stats.longestNode << "\n"
+            << "Median depth:                     " << stats.medianDepthByBase << "\n"
+            << "Estimated sequence length (bp):   " << stats.estimatedSequenceLength << "\n";
+        if (g_assemblyGraph->m_loadThroughput > 0)
+            out << "Load throughput (MB/s):           " << g_assemblyGraph->m_loadThroughput << "\n";
+
+        size_t unsharedSequenceBytes = 0, storedSequenceBytes = 0;
+        g_assemblyGraph->getPackedSequenceMemory(&unsharedSequenceBytes, &storedSequenceBytes);
+        out << "Packed sequence unshared (bytes): " << unsharedSequenceBytes << "\n"
+            << "Packed sequence stored (bytes):   " << storedSequenceBytes << "\n";
     }
 
     return 0;
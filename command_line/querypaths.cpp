@@ -41,7 +41,9 @@ CLI::App *addQueryPathsSubcommand(CLI::App &app,
     qp->add_flag("--hitsfasta", cmd.m_hitsFasta, "Produce a multi-FASTA file of all BLAST hits in the query paths");
     qp->add_flag("--gfapaths", cmd.m_gfaPaths, "Align to GFA path sequences in addition to nodes");
 
-    qp->footer("Bandage querypaths searches for queries in the graph using BLAST and outputs the results to a tab-delimited file.");
+    qp->footer("Bandage querypaths searches for queries in the graph using BLAST and outputs the results to a tab-delimited file.\n\n"
+               "The search for paths between two hits stops after " + std::to_string(Path::MaxPathSearchCandidates) +
+               " candidate paths. Queries for which this happened are reported in the summary and may have incomplete paths.");
 
     return qp;
 
@@ -253,6 +255,18 @@ int handleQueryPathsCmd(QApplication *app,
     out << "         Queries with found paths:      " << g_blastSearch->getQueryCountWithAtLeastOnePath() << Qt::endl;
     out << "         Total query paths:             " << g_blastSearch->getQueryPathCount() << Qt::endl;
 
+    unsigned truncatedQueries = 0;
+    for (const auto *query : g_blastSearch->queries()) {
+        if (!query->isPathSearchTruncated())
+            continue;
+
+        ++truncatedQueries;
+        err << "Bandage-NG warning: path search for query " << query->getName()
+            << " stopped after " << Path::MaxPathSearchCandidates
+            << " candidate paths, its paths may be incomplete" << Qt::endl;
+    }
+    out << "         Queries with truncated search: " << truncatedQueries << Qt::endl;
+
     out << Qt::endl << "Elapsed time: " << getElapsedTime(startTime, QDateTime::currentDateTime()) << Qt::endl;
 
     return 0;
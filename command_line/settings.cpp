@@ -266,6 +266,8 @@ static CLI::App *addGraphSizeSettings(CLI::App &app) {
     add_setting(*size, "--edgewidth", g_settings->edgeWidth, "Edge width");
     add_setting(*size, "--linkwidth", g_settings->linkWidth, "Link edge width");
     size->add_flag("--jumps-as-links", g_settings->jumpsAsLinks, "Treap GFA v1.2 jumps as links");
+    add_setting(*size, "--loadthreads", g_settings->loaderThreads, "Number of threads used to parse GFA input (0 = all available)");
+    size->add_flag("--twopass", g_settings->twoPassLoading, "Load GFA segments before links, paths and walks (reads the file twice)");
     add_setting(*size, "--doubsep", g_settings->doubleModeNodeSeparation, "Double mode node separation");
     size->callback([size]() {
         if (size->count("--nodelen"))
@@ -279,6 +281,13 @@ static CLI::App *addGraphLayoutSettings(CLI::App &app) {
     auto *layout = app.add_option_group("Graph layout");
     add_setting(*layout, "--nodseglen", g_settings->nodeSegmentLength, "Node segment length");
     add_setting(*layout, "--iter", g_settings->graphLayoutQuality, "Graph layout iterations");
+    layout->add_option("--layoutalgo", g_settings->graphLayoutAlgorithm,
+                       "Graph layout algorithm, from one of the following options: fmmm, fme (multithreaded fast multipole embedder, for very large graphs)")
+            ->transform(CLI::CheckedTransformer(
+                std::vector<std::pair<std::string, GraphLayoutAlgorithm>>{
+                    {"fmmm", FMMM_LAYOUT},
+                    {"fme", FAST_MULTIPOLE_LAYOUT}}))
+            ->default_val("fmmm");
     layout->add_flag("--linear", g_settings->linearLayout, "Linear graph layout")
             ->capture_default_str();
 
@@ -20,18 +20,22 @@
 #include "graphicsitemnode.h"
 #include "program/settings.h"
 
+#include <QFontMetrics>
 #include <QPen>
 #include <QPainter>
 
-void SolidView::drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-                           int64_t end) const {
+#include <algorithm>
+#include <cmath>
+
+void SolidView::drawRange(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                          QRgb colour, int64_t start, int64_t end) const {
     QPen pen;
     pen.setCapStyle(Qt::FlatCap);
     pen.setJoinStyle(Qt::BevelJoin);
 
     pen.setWidthF(m_widthMultiplier * graphicsItemNode.m_width);
 
-    pen.setColor(m_color);
+    pen.setColor(QColor::fromRgba(colour));
     painter.setPen(pen);
 
     double fractionStart = graphicsItemNode.indexToFraction(start);
@@ -45,14 +49,15 @@ void SolidView::drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode
 }
 
 void RainbowBlastHitView::drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
-                                     int64_t start, int64_t end) const {
+                                     const AnnotationStore &store, AnnotationStore::FeatureId id) const {
+    double rainbowFractionStart = store.rainbowStart(id), rainbowFractionEnd = store.rainbowEnd(id);
 
     double scaledNodeLength = graphicsItemNode.getNodePathLength() * g_absoluteZoom;
-    double fractionStart = graphicsItemNode.indexToFraction(start);
-    double fractionEnd = graphicsItemNode.indexToFraction(end + 1);
+    double fractionStart = graphicsItemNode.indexToFraction(store.start(id));
+    double fractionEnd = graphicsItemNode.indexToFraction(store.end(id) + 1);
     double scaledHitLength = (fractionEnd - fractionStart) * scaledNodeLength;
     int partCount = ceil(
-            g_settings->blastRainbowPartsPerQuery * fabs(m_rainbowFractionStart - m_rainbowFractionEnd));
+            g_settings->blastRainbowPartsPerQuery * fabs(rainbowFractionStart - rainbowFractionEnd));
 
     //If there are way more parts than the scaled hit length, that means
     //that a single part will be much less than a pixel in length.  This
@@ -61,10 +66,10 @@ void RainbowBlastHitView::drawFigure(QPainter &painter, GraphicsItemNode &graphi
         partCount = int(scaledHitLength * 2.0);
 
     double nodeSpacing = (fractionEnd - fractionStart) / partCount;
-    double rainbowSpacing = (m_rainbowFractionEnd - m_rainbowFractionStart) / partCount;
+    double rainbowSpacing = (rainbowFractionEnd - rainbowFractionStart) / partCount;
 
     double nodeFraction = fractionStart;
-    double rainbowFraction = m_rainbowFractionStart;
+    double rainbowFraction = rainbowFractionStart;
 
     QPen pen;
     pen.setCapStyle(Qt::FlatCap);
@@ -90,39 +95,92 @@ void RainbowBlastHitView::drawFigure(QPainter &painter, GraphicsItemNode &graphi
     }
 }
 
-void Annotation::drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
-                            const std::set<ViewId> &viewsToShow) const {
-    for (auto view_id : viewsToShow) {
-        m_views[view_id]->drawFigure(painter, graphicsItemNode, reverseComplement, m_start, m_end);
-    }
-}
-
-void Annotation::drawDescription(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement) const {
-    double annotationCenter =
-            (graphicsItemNode.indexToFraction(m_start) + graphicsItemNode.indexToFraction(m_end)) / 2;
-    auto textPoint = graphicsItemNode.findLocationOnPath(
-            reverseComplement ? 1 - annotationCenter : annotationCenter);
-    auto qStringText = QString::fromStdString(m_text);
-
-    QPainterPath textPath;
-    QFontMetrics metrics(g_settings->labelFont);
-    double shiftLeft = -metrics.boundingRect(qStringText).width() / 2.0;
-    textPath.addText(shiftLeft, 0.0, g_settings->labelFont, qStringText);
+void drawAnnotations(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                     const AnnotationStore &store, const DeBruijnNode *node,
+                     const AnnotationViews &views, const std::set<ViewId> &viewsToShow,
+                     int64_t from, int64_t to, double pixelsPerBase) {
+    if (viewsToShow.empty() || from > to || pixelsPerBase <= 0)
+        return;
+
+    // Small features are accumulated into bins MinAnnotationPixels wide, the
+    // bin colour is the colour of the last feature there and its opacity
+    // depends on the number of features.
+    struct Bin {
+        unsigned count = 0;
+        QRgb colour = 0;
+    };
+    int64_t binBases = std::max<int64_t>(1, int64_t(std::ceil(MinAnnotationPixels / pixelsPerBase)));
+    std::vector<Bin> bins;
+
+    store.forEachOverlapping(node, from, to, [&](AnnotationStore::FeatureId id) {
+        int64_t start = store.start(id), end = store.end(id);
+        if ((end - start + 1) * pixelsPerBase >= MinAnnotationPixels) {
+            for (auto viewId : viewsToShow)
+                views[viewId]->drawFigure(painter, graphicsItemNode, reverseComplement, store, id);
+            return;
+        }
+
+        if (bins.empty())
+            bins.resize((to - from) / binBases + 1);
+        size_t firstBin = (std::max(start, from) - from) / binBases;
+        size_t lastBin = (std::min(end, to) - from) / binBases;
+        for (size_t i = firstBin; i <= lastBin; ++i) {
+            bins[i].count += 1;
+            bins[i].colour = store.colour(id);
+        }
+    });
+
+    if (bins.empty())
+        return;
+
+    unsigned maxCount = std::max_element(bins.begin(), bins.end(),
+                                         [](const Bin &a, const Bin &b) { return a.count < b.count; })->count;
+    QPen pen;
+    pen.setCapStyle(Qt::FlatCap);
+    pen.setJoinStyle(Qt::BevelJoin);
+    pen.setWidthF(graphicsItemNode.m_width);
+    for (size_t i = 0; i < bins.size(); ++i) {
+        if (!bins[i].count)
+            continue;
 
-    GraphicsItemNode::drawTextPathAtLocation(&painter, textPath, textPoint);
-}
+        QColor colour = QColor::fromRgba(bins[i].colour);
+        colour.setAlphaF(float(0.25 + 0.75 * bins[i].count / maxCount));
+        pen.setColor(colour);
+        painter.setPen(pen);
 
-BedBlockView::BedBlockView(double widthMultiplier, const QColor &color, const std::vector<bed::Block> &blocks)
-        : m_widthMultiplier(widthMultiplier), m_color(color) {
-    m_blocks.reserve(blocks.size());
-    for (const auto &block: blocks) {
-        m_blocks.emplace_back(widthMultiplier, color, block.start, block.end);
+        int64_t start = from + int64_t(i) * binBases;
+        int64_t end = std::min(start + binBases, to + 1);
+        double fractionStart = graphicsItemNode.indexToFraction(start);
+        double fractionEnd = graphicsItemNode.indexToFraction(end);
+        if (reverseComplement) {
+            fractionStart = 1 - fractionStart;
+            fractionEnd = 1 - fractionEnd;
+        }
+        painter.drawPath(graphicsItemNode.makePartialPath(fractionStart, fractionEnd));
     }
 }
 
-void BedBlockView::drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-                              int64_t end) const {
-    for (const auto &block: m_blocks) {
-        block.drawFigure(painter, graphicsItemNode, reverseComplement, start, end);
-    }
+void drawAnnotationDescriptions(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                                const AnnotationStore &store, const DeBruijnNode *node,
+                                int64_t from, int64_t to, double pixelsPerBase) {
+    QFontMetrics metrics(g_settings->labelFont);
+    store.forEachOverlapping(node, from, to, [&](AnnotationStore::FeatureId id) {
+        int64_t start = store.start(id), end = store.end(id);
+        // Features merged into density bars are not labelled
+        if ((end - start + 1) * pixelsPerBase < MinAnnotationPixels)
+            return;
+
+        double annotationCenter =
+                (graphicsItemNode.indexToFraction(start) + graphicsItemNode.indexToFraction(end)) / 2;
+        auto textPoint = graphicsItemNode.findLocationOnPath(
+                reverseComplement ? 1 - annotationCenter : annotationCenter);
+        std::string_view name = store.name(id);
+        auto qStringText = QString::fromUtf8(name.data(), qsizetype(name.size()));
+
+        QPainterPath textPath;
+        double shiftLeft = -metrics.boundingRect(qStringText).width() / 2.0;
+        textPath.addText(shiftLeft, 0.0, g_settings->labelFont, qStringText);
+
+        GraphicsItemNode::drawTextPathAtLocation(&painter, textPath, textPoint);
+    });
 }
@@ -18,10 +18,14 @@
 
 #pragma once
 
-#include "io/bed.h"
+#include "annotationstore.h"
 
+#include <QString>
+
+#include <memory>
 #include <utility>
 #include <set>
+#include <vector>
 
 using AnnotationGroupId = int;
 using ViewId = int;
@@ -29,11 +33,13 @@ using ViewId = int;
 class QPainter;
 class GraphicsItemNode;
 
+// Views are shared by all features of an annotation group, the per-feature
+// data (colour, thick part, blocks, ...) is taken from the group store.
 class IAnnotationView {
 public:
     virtual void
-    drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-               int64_t end) const = 0;
+    drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+               const AnnotationStore &store, AnnotationStore::FeatureId id) const = 0;
 
     [[nodiscard]] virtual QString getTypeName() const = 0;
 
@@ -43,96 +49,79 @@ public:
 
 class SolidView : public IAnnotationView {
 public:
-    SolidView(double widthMultiplier, const QColor &color) : m_widthMultiplier(widthMultiplier), m_color(color) {}
+    explicit SolidView(double widthMultiplier) : m_widthMultiplier(widthMultiplier) {}
 
-    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-                    int64_t end) const override;
+    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                    const AnnotationStore &store, AnnotationStore::FeatureId id) const override {
+        drawRange(painter, graphicsItemNode, reverseComplement, store.colour(id), store.start(id), store.end(id));
+    }
 
     [[nodiscard]] QString getTypeName() const override {
         return "Solid";
     }
 
+protected:
+    void drawRange(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                   QRgb colour, int64_t start, int64_t end) const;
+
 private:
     const double m_widthMultiplier;
-    const QColor m_color;
 };
 
 class RainbowBlastHitView : public IAnnotationView {
 public:
-    RainbowBlastHitView(double rainbowFractionStart, double rainbowFractionEnd)
-            : m_rainbowFractionStart(rainbowFractionStart), m_rainbowFractionEnd(rainbowFractionEnd) {}
-
-    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-                    int64_t end) const override;
+    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                    const AnnotationStore &store, AnnotationStore::FeatureId id) const override;
 
     [[nodiscard]] QString getTypeName() const override {
         return "Rainbow";
     }
-
-private:
-    double m_rainbowFractionStart;
-    double m_rainbowFractionEnd;
 };
 
 
 class BedThickView : public SolidView {
 public:
-    BedThickView(double widthMultiplier, const QColor &color, int64_t mThickStart, int64_t mThickEnd) : SolidView(
-            widthMultiplier, color), m_thickStart(mThickStart), m_thickEnd(mThickEnd) {}
+    explicit BedThickView(double widthMultiplier) : SolidView(widthMultiplier) {}
 
-    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t,
-                    int64_t) const override {
-        SolidView::drawFigure(painter, graphicsItemNode, reverseComplement, m_thickStart, m_thickEnd);
+    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                    const AnnotationStore &store, AnnotationStore::FeatureId id) const override {
+        drawRange(painter, graphicsItemNode, reverseComplement, store.colour(id), store.thickStart(id), store.thickEnd(id));
     }
 
     [[nodiscard]] QString getTypeName() const override {
         return "BED Thick";
     }
-
-private:
-    int64_t m_thickStart;
-    int64_t m_thickEnd;
 };
 
 
-class BedBlockView : public IAnnotationView {
+class BedBlockView : public SolidView {
 public:
-    BedBlockView(double widthMultiplier, const QColor &color, const std::vector<bed::Block> &blocks);
+    explicit BedBlockView(double widthMultiplier) : SolidView(widthMultiplier) {}
 
-    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement, int64_t start,
-                    int64_t end) const override;
+    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                    const AnnotationStore &store, AnnotationStore::FeatureId id) const override {
+        for (const auto &block : store.blocks(id))
+            drawRange(painter, graphicsItemNode, reverseComplement, store.colour(id), block.start, block.end);
+    }
 
     [[nodiscard]] QString getTypeName() const override {
         return "BED Blocks";
     }
-
-private:
-    const double m_widthMultiplier;
-    const QColor m_color;
-    std::vector<BedThickView> m_blocks;
 };
 
+using AnnotationViews = std::vector<std::unique_ptr<IAnnotationView>>;
 
-class Annotation {
-public:
-    Annotation(int64_t start, int64_t end, std::string text) : m_start(start), m_end(end), m_text(std::move(text)) {}
-
-    void drawFigure(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
-                    const std::set<ViewId> &viewsToShow) const;
-
-    void drawDescription(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement) const;
-
-    void addView(std::unique_ptr<IAnnotationView> view) {
-        m_views.emplace_back(std::move(view));
-    }
+// Features shorter than this on screen are not drawn one by one, but are
+// merged into a density bar instead.
+inline constexpr double MinAnnotationPixels = 2.0;
 
-    [[nodiscard]] const std::vector<std::unique_ptr<IAnnotationView>> &getViews() const {
-        return m_views;
-    }
+// Draws the features of the node overlapping [from, to]. pixelsPerBase is the
+// on-screen length of a single base of the node.
+void drawAnnotations(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                     const AnnotationStore &store, const DeBruijnNode *node,
+                     const AnnotationViews &views, const std::set<ViewId> &viewsToShow,
+                     int64_t from, int64_t to, double pixelsPerBase);
 
-private:
-    int64_t m_start;
-    int64_t m_end;
-    std::string m_text;
-    std::vector<std::unique_ptr<IAnnotationView>> m_views;
-};
\ No newline at end of file
+void drawAnnotationDescriptions(QPainter &painter, GraphicsItemNode &graphicsItemNode, bool reverseComplement,
+                                const AnnotationStore &store, const DeBruijnNode *node,
+                                int64_t from, int64_t to, double pixelsPerBase);
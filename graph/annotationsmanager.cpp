@@ -21,6 +21,10 @@
 #include "graphsearch/query.h"
 #include "program/settings.h"
 
+inline constexpr double BED_MAIN_WIDTH = 1;
+inline constexpr double BED_THICK_WIDTH = 1.3;
+inline constexpr double BED_BLOCK_WIDTH = 1.6;
+
 AnnotationGroup &AnnotationsManager::createAnnotationGroup(QString name) {
     if (name == g_settings->blastAnnotationGroupName) {
         // To be removed when we can set up annotations from CLI properly.
@@ -32,12 +36,20 @@ AnnotationGroup &AnnotationsManager::createAnnotationGroup(QString name) {
 AnnotationGroup &AnnotationsManager::createAnnotationGroup(QString name, const AnnotationSetting &setting) {
     g_settings->annotationsSettings[nextFreeId] = setting;
     m_annotationGroups.emplace_back(
-            std::make_unique<AnnotationGroup>(AnnotationGroup{nextFreeId, std::move(name), {}}));
+            std::make_unique<AnnotationGroup>(AnnotationGroup{nextFreeId, std::move(name), {}, {}}));
     nextFreeId++;
     emit annotationGroupsUpdated();
     return *m_annotationGroups.back();
 }
 
+AnnotationGroup &AnnotationsManager::createBedAnnotationGroup(QString name) {
+    auto &group = createAnnotationGroup(std::move(name));
+    group.views.emplace_back(std::make_unique<SolidView>(BED_MAIN_WIDTH));
+    group.views.emplace_back(std::make_unique<BedThickView>(BED_THICK_WIDTH));
+    group.views.emplace_back(std::make_unique<BedBlockView>(BED_BLOCK_WIDTH));
+    return group;
+}
+
 const AnnotationsManager::AnnotationGroupVector &AnnotationsManager::getGroups() const {
     return m_annotationGroups;
 }
@@ -94,18 +106,17 @@ void AnnotationsManager::updateGroupFromHits(const QString &name, const std::vec
         return;
 
     auto &group = createAnnotationGroup(name);
+    group.views.emplace_back(std::make_unique<SolidView>(1.0));
+    group.views.emplace_back(std::make_unique<RainbowBlastHitView>());
     for (auto *query: queries) {
+        std::string queryName = query->getName().toStdString();
+        QRgb colour = query->getColour().rgba();
         for (const auto &hit: query->getHits()) {
-            auto &annotation = group.annotationMap[hit->m_node].emplace_back(
-                    std::make_unique<Annotation>(
-                            hit->m_nodeStart,
-                            hit->m_nodeEnd,
-                            query->getName().toStdString()));
-            annotation->addView(std::make_unique<SolidView>(1.0, query->getColour()));
-            annotation->addView(std::make_unique<RainbowBlastHitView>(hit->queryStartFraction(),
-                                                                      hit->queryEndFraction()));
+            auto id = group.annotations.add(hit->m_node, hit->m_nodeStart, hit->m_nodeEnd, colour, queryName);
+            group.annotations.setRainbow(id, hit->queryStartFraction(), hit->queryEndFraction());
         }
     }
+    group.annotations.buildIndex();
 
     g_settings->annotationsSettings[group.id] = groupSettings;
 
@@ -20,7 +20,6 @@
 
 #include "annotation.h"
 #include <QObject>
-#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -47,21 +46,11 @@ const V &getFromMapOrDefaultConstructed(const MapLike<K, V> &map, const K &key)
 #endif
 
 struct AnnotationGroup {
-    using AnnotationVector = std::vector<std::unique_ptr<Annotation>>;
-    using AnnotationMap = std::unordered_map<const DeBruijnNode *, AnnotationVector>;
-
     const AnnotationGroupId id;
     const QString name;
-    AnnotationMap annotationMap;
-
-    const AnnotationVector &getAnnotations(const DeBruijnNode *node) const {
-            auto it = annotationMap.find(node);
-            if (it != annotationMap.end())
-                return it->second;
-
-            static const AnnotationVector defaultConstructed{};
-            return defaultConstructed;
-    }
+    // All features of the group are drawn with the same set of views
+    AnnotationViews views;
+    AnnotationStore annotations;
 };
 
 class AnnotationsManager : public QObject {
@@ -74,6 +63,8 @@ public:
 
     AnnotationGroup &createAnnotationGroup(QString name);
     AnnotationGroup &createAnnotationGroup(QString name, const AnnotationSetting &setting);
+    // Creates a group with the BED views: the feature, its thick part and blocks
+    AnnotationGroup &createBedAnnotationGroup(QString name);
 
     const AnnotationGroupVector &getGroups() const;
     void removeGroupByName(const QString &name);
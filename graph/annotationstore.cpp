@@ -0,0 +1,113 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "annotationstore.h"
+
+#include <numeric>
+
+AnnotationStore::FeatureId AnnotationStore::add(const DeBruijnNode *node,
+                                                int64_t start, int64_t end,
+                                                QRgb colour, std::string_view name) {
+    auto id = FeatureId(m_starts.size());
+    m_nodes.push_back(node);
+    m_starts.push_back(start);
+    m_ends.push_back(end);
+    m_colours.push_back(colour);
+    m_names.insert(m_names.end(), name.begin(), name.end());
+    m_nameOffsets.push_back(m_names.size());
+
+    // Keep the optional columns that are already in use in sync
+    if (hasThick()) {
+        m_thickStarts.push_back(start);
+        m_thickEnds.push_back(end);
+    }
+    if (hasBlocks())
+        m_blockOffsets.push_back(m_blocks.size());
+    if (hasRainbow()) {
+        m_rainbowStarts.push_back(0);
+        m_rainbowEnds.push_back(0);
+    }
+
+    return id;
+}
+
+void AnnotationStore::setThick(FeatureId id, int64_t thickStart, int64_t thickEnd) {
+    if (!hasThick()) {
+        m_thickStarts = m_starts;
+        m_thickEnds = m_ends;
+    }
+
+    m_thickStarts[id] = thickStart;
+    m_thickEnds[id] = thickEnd;
+}
+
+void AnnotationStore::setBlocks(FeatureId id, const std::vector<bed::Block> &blocks) {
+    if (!hasBlocks())
+        m_blockOffsets.assign(m_starts.size() + 1, 0);
+
+    m_blocks.insert(m_blocks.end(), blocks.begin(), blocks.end());
+    m_blockOffsets[id + 1] = m_blocks.size();
+}
+
+void AnnotationStore::setRainbow(FeatureId id, float rainbowStart, float rainbowEnd) {
+    if (!hasRainbow()) {
+        m_rainbowStarts.assign(m_starts.size(), 0);
+        m_rainbowEnds.assign(m_starts.size(), 0);
+    }
+
+    m_rainbowStarts[id] = rainbowStart;
+    m_rainbowEnds[id] = rainbowEnd;
+}
+
+void AnnotationStore::buildIndex() {
+    m_order.resize(m_starts.size());
+    std::iota(m_order.begin(), m_order.end(), 0);
+    std::sort(m_order.begin(), m_order.end(),
+              [&](FeatureId a, FeatureId b) {
+                  if (m_nodes[a] != m_nodes[b])
+                      return m_nodes[a] < m_nodes[b];
+                  return m_starts[a] < m_starts[b];
+              });
+
+    m_maxEnds.resize(m_order.size());
+    m_nodeNodes.clear();
+    m_nodeRanges.clear();
+    for (uint32_t begin = 0, end = 0; begin < m_order.size(); begin = end) {
+        const DeBruijnNode *node = m_nodes[m_order[begin]];
+        int64_t maxEnd = m_ends[m_order[begin]];
+        for (end = begin; end < m_order.size() && m_nodes[m_order[end]] == node; ++end) {
+            maxEnd = std::max(maxEnd, m_ends[m_order[end]]);
+            m_maxEnds[end] = maxEnd;
+        }
+
+        m_nodeNodes.push_back(node);
+        m_nodeRanges.emplace(node, std::make_pair(begin, end));
+    }
+}
+
+void AnnotationStore::clear() {
+    *this = AnnotationStore();
+}
+
+llvm::iterator_range<const AnnotationStore::FeatureId*>
+AnnotationStore::features(const DeBruijnNode *node) const {
+    auto it = m_nodeRanges.find(node);
+    if (it == m_nodeRanges.end())
+        return llvm::make_range(m_order.data(), m_order.data());
+
+    return llvm::make_range(m_order.data() + it->second.first, m_order.data() + it->second.second);
+}
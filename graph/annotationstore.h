@@ -0,0 +1,130 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "io/bed.h"
+
+#include "parallel_hashmap/phmap.h"
+#include "llvm/ADT/iterator_range.h"
+
+#include <QRgb>
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class DeBruijnNode;
+
+// Columnar storage for the annotation features of a single group. Every
+// feature is just an index into the columns; optional columns (thick part,
+// blocks, rainbow fractions) are allocated only when the first feature uses
+// them. Features are additionally indexed per node and sorted by start, so
+// features overlapping a given range of a node could be found without scanning
+// all of them. The index has to be rebuilt after features are added.
+class AnnotationStore {
+  public:
+    using FeatureId = uint32_t;
+
+    FeatureId add(const DeBruijnNode *node, int64_t start, int64_t end, QRgb colour, std::string_view name);
+    void setThick(FeatureId id, int64_t thickStart, int64_t thickEnd);
+    // Blocks could only be set for the most recently added feature
+    void setBlocks(FeatureId id, const std::vector<bed::Block> &blocks);
+    void setRainbow(FeatureId id, float rainbowStart, float rainbowEnd);
+
+    void buildIndex();
+    void clear();
+
+    [[nodiscard]] size_t size() const { return m_starts.size(); }
+    [[nodiscard]] bool empty() const { return m_starts.empty(); }
+
+    [[nodiscard]] const DeBruijnNode *node(FeatureId id) const { return m_nodes[id]; }
+    [[nodiscard]] int64_t start(FeatureId id) const { return m_starts[id]; }
+    [[nodiscard]] int64_t end(FeatureId id) const { return m_ends[id]; }
+    [[nodiscard]] QRgb colour(FeatureId id) const { return m_colours[id]; }
+    [[nodiscard]] std::string_view name(FeatureId id) const {
+        return { m_names.data() + m_nameOffsets[id], m_nameOffsets[id + 1] - m_nameOffsets[id] };
+    }
+
+    [[nodiscard]] bool hasThick() const { return !m_thickStarts.empty(); }
+    // Without the thick column the whole feature is thick
+    [[nodiscard]] int64_t thickStart(FeatureId id) const { return hasThick() ? m_thickStarts[id] : m_starts[id]; }
+    [[nodiscard]] int64_t thickEnd(FeatureId id) const { return hasThick() ? m_thickEnds[id] : m_ends[id]; }
+
+    [[nodiscard]] bool hasBlocks() const { return !m_blockOffsets.empty(); }
+    [[nodiscard]] llvm::iterator_range<const bed::Block*> blocks(FeatureId id) const {
+        if (!hasBlocks())
+            return llvm::make_range(m_blocks.data(), m_blocks.data());
+        return llvm::make_range(m_blocks.data() + m_blockOffsets[id], m_blocks.data() + m_blockOffsets[id + 1]);
+    }
+
+    [[nodiscard]] bool hasRainbow() const { return !m_rainbowStarts.empty(); }
+    [[nodiscard]] float rainbowStart(FeatureId id) const { return m_rainbowStarts[id]; }
+    [[nodiscard]] float rainbowEnd(FeatureId id) const { return m_rainbowEnds[id]; }
+
+    // Nodes having at least one feature
+    [[nodiscard]] auto nodes() const {
+        return llvm::make_range(m_nodeNodes.data(), m_nodeNodes.data() + m_nodeNodes.size());
+    }
+
+    // All features of the node, sorted by start
+    [[nodiscard]] llvm::iterator_range<const FeatureId*> features(const DeBruijnNode *node) const;
+    [[nodiscard]] bool hasFeatures(const DeBruijnNode *node) const { return m_nodeRanges.contains(node); }
+
+    // Calls fn(id) for every feature of the node overlapping [from, to]
+    template<class Fn>
+    void forEachOverlapping(const DeBruijnNode *node, int64_t from, int64_t to, Fn fn) const {
+        auto it = m_nodeRanges.find(node);
+        if (it == m_nodeRanges.end())
+            return;
+
+        auto [begin, end] = it->second;
+        // m_maxEnds is non-decreasing within the node range, so the first
+        // feature that could reach 'from' is found by binary search. Features
+        // starting after 'to' end the scan.
+        const int64_t *maxEnds = m_maxEnds.data();
+        uint32_t first = std::lower_bound(maxEnds + begin, maxEnds + end, from) - maxEnds;
+        for (uint32_t i = first; i < end; ++i) {
+            FeatureId id = m_order[i];
+            if (m_starts[id] > to)
+                break;
+            if (m_ends[id] >= from)
+                fn(id);
+        }
+    }
+
+  private:
+    std::vector<const DeBruijnNode*> m_nodes;
+    std::vector<int64_t> m_starts, m_ends;
+    std::vector<QRgb> m_colours;
+    std::vector<uint64_t> m_nameOffsets = { 0 };
+    std::vector<char> m_names;
+
+    std::vector<int64_t> m_thickStarts, m_thickEnds;
+    std::vector<uint32_t> m_blockOffsets;
+    std::vector<bed::Block> m_blocks;
+    std::vector<float> m_rainbowStarts, m_rainbowEnds;
+
+    // Per-node index: features of every node occupy a contiguous range of
+    // m_order sorted by start; m_maxEnds holds the running maximum of ends
+    // over the range.
+    std::vector<FeatureId> m_order;
+    std::vector<int64_t> m_maxEnds;
+    std::vector<const DeBruijnNode*> m_nodeNodes;
+    phmap::flat_hash_map<const DeBruijnNode*, std::pair<uint32_t, uint32_t>> m_nodeRanges;
+};
@@ -41,6 +41,7 @@
 #include <QQueue>
 #include <QRegularExpression>
 #include <QSet>
+#include <QtConcurrent>
 
 #include <algorithm>
 #include <iterator>
@@ -79,32 +80,32 @@ template<typename T> double getValueUsingFractionalIndex(const std::vector<T> &v
     return piece1 * (1.0 - fractionalPart) + piece2 * fractionalPart;
 }
 
+DeBruijnNode *AssemblyGraph::createNode(std::string_view name,
+                                        float depth, const Sequence &sequence, unsigned length) {
+    // Both nodes of a complementary pair share the same interned name
+    bool positive = name.empty() || name.back() != '-';
+    if (!name.empty() && (name.back() == '+' || name.back() == '-'))
+        name.remove_suffix(1);
+
+    m_nodeMetrics.clear();
+    return m_nodeArena.create(m_nodeNames.intern(name), positive, depth, sequence, length);
+}
+
 void AssemblyGraph::cleanUp() {
     m_deBruijnGraphPaths.clear();
     m_deBruijnGraphWalks.clear();
-
-    // There might be duplicate entries due to self-rc nodes, so we need to
-    // track what was already deleted :(
-    // FIXME: Allocate all nodes from common arena, we should be fine with
-    // LLVM's BumpPtr allocator
-    phmap::parallel_flat_hash_set<DeBruijnNode*> deleted;
-    {
-        for (auto &entry : m_deBruijnGraphNodes) {
-            if (deleted.contains(entry))
-                continue;
-            delete entry;
-            deleted.insert(entry);
-        }
-        m_deBruijnGraphNodes.clear();
-    }
-
-    {
-        for (DeBruijnEdge *edge : m_deBruijnGraphEdges) {
-            delete edge;
-            edge = nullptr;
-        }
-        m_deBruijnGraphEdges.clear();
-    }
+    m_pathStore.clear();
+    m_walkStore.clear();
+    m_pathIndex.clear();
+    m_walkIndex.clear();
+
+    // Nodes and edges are owned by the arenas, so release them in bulk. Note
+    // that self-rc nodes are recorded twice in the node map.
+    m_deBruijnGraphNodes.clear();
+    m_deBruijnGraphEdges.clear();
+    m_nodeArena.clear();
+    m_edgeArena.clear();
+    m_nodeNames.clear();
 
     m_nodeTags.clear();
     m_edgeTags.clear();
@@ -158,13 +159,13 @@ void AssemblyGraph::createDeBruijnEdge(const QString& node1Name, const QString&
     //for an edge to be its own pair.
     bool isOwnPair = (*node1 == *negNode2 && *node2 == *negNode1);
 
-    auto * forwardEdge = new DeBruijnEdge(*node1, *node2);
+    auto * forwardEdge = createEdge(*node1, *node2);
     DeBruijnEdge * backwardEdge;
 
     if (isOwnPair)
         backwardEdge = forwardEdge;
     else
-        backwardEdge = new DeBruijnEdge(*negNode2, *negNode1);
+        backwardEdge = createEdge(*negNode2, *negNode1);
 
     forwardEdge->setReverseComplement(backwardEdge);
     backwardEdge->setReverseComplement(forwardEdge);
@@ -253,6 +254,31 @@ double AssemblyGraph::getMeanDepth(const std::vector<DeBruijnNode *> &nodes)
 }
 
 
+bool AssemblyGraph::addPath(std::string_view name, const Path &path) {
+    auto [it, inserted] = m_deBruijnGraphPaths.emplace(name, graph::PathStore::Id(m_pathStore.size()));
+    if (inserted)
+        m_pathStore.add(path);
+
+    return inserted;
+}
+
+bool AssemblyGraph::addWalk(std::string_view name, Walk walk, const Path &path) {
+    walk.pathId = graph::PathStore::Id(m_walkStore.size());
+    auto [it, inserted] = m_deBruijnGraphWalks.emplace(name, std::move(walk));
+    if (inserted)
+        m_walkStore.add(path);
+
+    return inserted;
+}
+
+// Needs to be called every time paths or walks are added
+void AssemblyGraph::buildPathIndices() {
+    m_pathIndex.build(m_deBruijnGraphPaths,
+                      [this](graph::PathStore::Id id) { return m_pathStore.nodes(id); });
+    m_walkIndex.build(m_deBruijnGraphWalks,
+                      [this](const Walk &walk) { return m_walkStore.nodes(walk.pathId); });
+}
+
 void AssemblyGraph::determineGraphInfo()
 {
     m_shortestContig = std::numeric_limits<long long>::max();
@@ -302,6 +328,8 @@ void AssemblyGraph::determineGraphInfo()
     m_medianDepth = getValueUsingFractionalIndex(nodeDepths, medianIndex);
     m_thirdQuartileDepth = getValueUsingFractionalIndex(nodeDepths, thirdQuartileIndex);
 
+    m_nodeMetrics.build(*this);
+
     //Set the auto node length setting. This is determined by aiming for a
     //target average node length. But if the graph is small, the value will be
     //increased (to avoid having an overly small and simple graph layout).
@@ -324,6 +352,10 @@ void AssemblyGraph::clearGraphInfo()
     m_firstQuartileDepth = 0.0;
     m_medianDepth = 0.0;
     m_thirdQuartileDepth = 0.0;
+
+    m_loadThroughput = 0.0;
+
+    m_nodeMetrics.clear();
 }
 
 /* Load data from CSV and add to deBruijnGraphNodes
@@ -394,7 +426,7 @@ bool AssemblyGraph::loadCSV(const QString &filename, QStringList *columns, QStri
         // scaffold paths (e.g. NODE_1_foo_1) and assign CSV data to all of them
         for (auto range = m_deBruijnGraphPaths.equal_prefix_range(nodeName.toStdString());
              range.first != range.second; ++range.first) {
-            for (auto *node : (*range.first).nodes()) {
+            for (auto *node : m_pathStore.nodes(*range.first)) {
                 nodes.emplace_back(node);
                 if (!g_settings->doubleMode)
                     nodes.emplace_back(node->getReverseComplement());
@@ -517,9 +549,14 @@ bool AssemblyGraph::loadGraphFromFile(const QString& filename) {
         return false;
 
     builder->treatJumpsAsLinks(g_settings->jumpsAsLinks);
+    builder->setThreads(g_settings->loaderThreads);
+    builder->useTwoPass(g_settings->twoPassLoading);
     if (auto E = builder->build(*this))
         return false;
 
+    m_loadThroughput = builder->throughput();
+
+    buildPathIndices();
     determineGraphInfo();
 
     // FIXME: get rid of this!
@@ -695,6 +732,7 @@ std::vector<DeBruijnNode *> AssemblyGraph::getNodesInDepthRange(double min, doub
 }
 
 void AssemblyGraph::setAllEdgesExactOverlap(int overlap) {
+    m_nodeMetrics.clear();
     for (DeBruijnEdge *edge : m_deBruijnGraphEdges) {
         edge->setExactOverlap(overlap);
     }
@@ -708,11 +746,31 @@ void AssemblyGraph::autoDetermineAllEdgesExactOverlap()
     if (edgeCount == 0)
         return;
 
-    //Determine the overlap for each edge.
+    m_nodeMetrics.clear();
+
+    //Determine the overlap for each edge.  The pseudorandom starting points
+    //of the searches are drawn in edge order, so the results do not depend on
+    //how the searches themselves are scheduled across threads.
+    struct OverlapSearch {
+        DeBruijnEdge *edge;
+        int min, max, firstOverlap;
+    };
+    std::vector<OverlapSearch> searches;
+    searches.reserve(edgeCount);
     for (DeBruijnEdge *edge : m_deBruijnGraphEdges) {
-        edge->autoDetermineExactOverlap();
+        edge->setOverlap(0);
+        edge->setOverlapType(AUTO_DETERMINED_EXACT_OVERLAP);
+
+        int min, max;
+        if (!edge->getExactOverlapSearchRange(&min, &max))
+            continue;
+        searches.push_back({ edge, min, max, min + (rand() % (max - min + 1)) });
     }
 
+    QtConcurrent::blockingMap(searches, [](const OverlapSearch &search) {
+        search.edge->setOverlap(search.edge->findExactOverlap(search.min, search.max, search.firstOverlap));
+    });
+
     //The expectation here is that most overlaps will be
     //the same or from a small subset of possible sizes.
     //Edges with an overlap that do not match the most common
@@ -752,7 +810,8 @@ void AssemblyGraph::autoDetermineAllEdgesExactOverlap()
 
     //For each edge, see if one of the more common overlaps also works.
     //If so, use that instead.
-    for (DeBruijnEdge *edge : m_deBruijnGraphEdges) {
+    std::vector<DeBruijnEdge *> edges(m_deBruijnGraphEdges.begin(), m_deBruijnGraphEdges.end());
+    QtConcurrent::blockingMap(edges, [&sortedOverlaps](DeBruijnEdge *edge) {
         for (int sortedOverlap : sortedOverlaps)
         {
             if (edge->getOverlap() == sortedOverlap)
@@ -763,7 +822,7 @@ void AssemblyGraph::autoDetermineAllEdgesExactOverlap()
                 break;
             }
         }
-    }
+    });
 }
 
 
@@ -838,10 +897,10 @@ void AssemblyGraph::deleteNodes(const std::vector<DeBruijnNode *> &nodes)
 
     //Build a list of edges to delete.
     std::vector<DeBruijnEdge *> edgesToDelete;
+    phmap::flat_hash_set<DeBruijnEdge *> addedEdges;
     for (auto *node : nodesToDelete) {
         for (auto *edge : node->edges()) {
-            bool alreadyAdded = std::find(edgesToDelete.begin(), edgesToDelete.end(), edge) != edgesToDelete.end();
-            if (!alreadyAdded)
+            if (addedEdges.insert(edge).second)
                 edgesToDelete.push_back(edge);
         }
     }
@@ -851,10 +910,10 @@ void AssemblyGraph::deleteNodes(const std::vector<DeBruijnNode *> &nodes)
 
     // Remove the nodes from the graph.
     for (auto *node : nodesToDelete)
-        m_deBruijnGraphNodes.erase(node->getName().toStdString());
+        m_deBruijnGraphNodes.erase(node->getStdName());
 
     for (auto *node : nodesToDelete)
-        delete node;
+        destroyNode(node);
 }
 
 void AssemblyGraph::deleteEdges(const std::vector<DeBruijnEdge *> &edges)
@@ -875,7 +934,7 @@ void AssemblyGraph::deleteEdges(const std::vector<DeBruijnEdge *> &edges)
         startingNode->removeEdge(edge);
         endingNode->removeEdge(edge);
 
-        delete edge;
+        destroyEdge(edge);
     }
 }
 
@@ -894,8 +953,8 @@ void AssemblyGraph::duplicateNodePair(DeBruijnNode * node, BandageGraphicsScene
     double newDepth = node->getDepth() / 2.0;
 
     //Create the new nodes.
-    auto * newPosNode = new DeBruijnNode(newPosNodeName, newDepth, originalPosNode->getSequence());
-    auto * newNegNode = new DeBruijnNode(newNegNodeName, newDepth, originalNegNode->getSequence());
+    auto * newPosNode = createNode(newPosNodeName, newDepth, originalPosNode->getSequence());
+    auto * newNegNode = createNode(newNegNodeName, newDepth, originalNegNode->getSequence());
     newPosNode->setReverseComplement(newNegNode);
     newNegNode->setReverseComplement(newPosNode);
 
@@ -1043,8 +1102,8 @@ bool AssemblyGraph::mergeNodes(QList<DeBruijnNode *> nodes, BandageGraphicsScene
     for (auto it = orderedList.rbegin(); it != orderedList.rend(); ++it)
         revCompOrderedList.push_back((*it)->getReverseComplement());
 
-    Path negPath = Path::makeFromOrderedNodes(revCompOrderedList, false);
-    Sequence mergedNodeNegSequence{negPath.getPathSequence()};
+    // The negative node is a view of the positive node sequence
+    Sequence mergedNodeNegSequence = mergedNodePosSequence.GetReverseComplement();
 
     QString newNodeBaseName;
     for (int i = 0; i < orderedList.size(); ++i) {
@@ -1058,8 +1117,8 @@ bool AssemblyGraph::mergeNodes(QList<DeBruijnNode *> nodes, BandageGraphicsScene
 
     double mergedNodeDepth = getMeanDepth(orderedList);
 
-    auto newPosNode = new DeBruijnNode(newPosNodeName, mergedNodeDepth, mergedNodePosSequence);
-    auto newNegNode = new DeBruijnNode(newNegNodeName, mergedNodeDepth, mergedNodeNegSequence);
+    auto newPosNode = createNode(newPosNodeName, mergedNodeDepth, mergedNodePosSequence);
+    auto newNegNode = createNode(newNegNodeName, mergedNodeDepth, mergedNodeNegSequence);
 
     newPosNode->setReverseComplement(newNegNode);
     newNegNode->setReverseComplement(newPosNode);
@@ -1087,11 +1146,10 @@ bool AssemblyGraph::mergeNodes(QList<DeBruijnNode *> nodes, BandageGraphicsScene
 }
 
 
-static bool mergeGraphicsNodes2(const std::vector<DeBruijnNode *> &originalNodes,
-                                DeBruijnNode *newNode,
-                                const AssemblyGraph &graph,
-                                BandageGraphicsScene *scene) {
-    bool success = true;
+//Builds a graphics item for the merged node by joining the line points of the
+//original nodes.  Returns nullptr if any of the original nodes is not drawn.
+static GraphicsItemNode *makeMergedGraphicsNode(const std::vector<DeBruijnNode *> &originalNodes,
+                                                DeBruijnNode *newNode) {
     std::vector<QPointF> linePoints;
 
     for (auto *node : originalNodes) {
@@ -1104,10 +1162,8 @@ static bool mergeGraphicsNodes2(const std::vector<DeBruijnNode *> &originalNodes
         }
 
         GraphicsItemNode * originalGraphicsItemNode = node->getGraphicsItemNode();
-        if (originalGraphicsItemNode == nullptr) {
-            success = false;
-            break;
-        }
+        if (originalGraphicsItemNode == nullptr)
+            return nullptr;
 
         const auto& originalLinePoints = originalGraphicsItemNode->m_linePoints;
 
@@ -1122,18 +1178,52 @@ static bool mergeGraphicsNodes2(const std::vector<DeBruijnNode *> &originalNodes
         }
     }
 
-    if (success) {
-        // We pass dummy width here, as node widths will be recalculated later
-        auto * newGraphicsItemNode = new GraphicsItemNode(newNode, 0, linePoints);
+    // We pass dummy width here, as node widths will be recalculated later
+    auto * newGraphicsItemNode = new GraphicsItemNode(newNode, 0, linePoints);
+
+    newNode->setGraphicsItemNode(newGraphicsItemNode);
+    newGraphicsItemNode->setFlag(QGraphicsItem::ItemIsSelectable);
+    newGraphicsItemNode->setFlag(QGraphicsItem::ItemIsMovable);
+    newGraphicsItemNode->setNodeColour(g_settings->nodeColorer->get(newGraphicsItemNode));
+
+    return newGraphicsItemNode;
+}
+
+static void addMergedGraphicsNodes(const std::vector<DeBruijnNode *> &originalNodes,
+                                   const std::vector<DeBruijnNode *> &revCompOriginalNodes,
+                                   DeBruijnNode * newNode,
+                                   BandageGraphicsScene * scene) {
+    if (auto *graphicsItemNode = makeMergedGraphicsNode(originalNodes, newNode)) {
+        scene->addItem(graphicsItemNode);
+        newNode->setAsDrawn();
+    }
 
-        newNode->setGraphicsItemNode(newGraphicsItemNode);
-        newGraphicsItemNode->setFlag(QGraphicsItem::ItemIsSelectable);
-        newGraphicsItemNode->setFlag(QGraphicsItem::ItemIsMovable);
-        newGraphicsItemNode->setNodeColour(g_settings->nodeColorer->get(newGraphicsItemNode));
+    if (g_settings->doubleMode) {
+        DeBruijnNode * newRevComp = newNode->getReverseComplement();
+        if (auto *graphicsItemNode = makeMergedGraphicsNode(revCompOriginalNodes, newRevComp)) {
+            scene->addItem(graphicsItemNode);
+            newRevComp->setAsDrawn();
+        }
+    }
+}
+
+//Creates graphics items for the edges of a merged node that do not have one
+//yet.  In single mode an edge is skipped if its reverse complement is already
+//shown.
+static void addMergedGraphicsEdges(DeBruijnNode * newNode,
+                                   const AssemblyGraph &graph,
+                                   BandageGraphicsScene * scene) {
+    for (auto *node : { newNode, newNode->getReverseComplement() }) {
+        if (node->getGraphicsItemNode() == nullptr)
+            continue;
 
-        scene->addItem(newGraphicsItemNode);
+        for (auto *newEdge : node->edges()) {
+            if (newEdge->getGraphicsItemEdge() != nullptr)
+                continue;
+            if (!g_settings->doubleMode &&
+                newEdge->getReverseComplement()->getGraphicsItemEdge() != nullptr)
+                continue;
 
-        for (auto *newEdge : newNode->edges()) {
             auto * graphicsItemEdge = new GraphicsItemEdge(newEdge, graph);
             graphicsItemEdge->setZValue(-1.0);
             newEdge->setGraphicsItemEdge(graphicsItemEdge);
@@ -1141,7 +1231,6 @@ static bool mergeGraphicsNodes2(const std::vector<DeBruijnNode *> &originalNodes
             scene->addItem(graphicsItemEdge);
         }
     }
-    return success;
 }
 
 static void mergeGraphicsNodes(const std::vector<DeBruijnNode *> &originalNodes,
@@ -1149,115 +1238,283 @@ static void mergeGraphicsNodes(const std::vector<DeBruijnNode *> &originalNodes,
                                DeBruijnNode * newNode,
                                const AssemblyGraph &graph,
                                BandageGraphicsScene * scene) {
-    bool success = mergeGraphicsNodes2(originalNodes, newNode, graph, scene);
-    if (success)
-        newNode->setAsDrawn();
+    if (scene == nullptr)
+        return;
 
-    if (g_settings->doubleMode) {
-        DeBruijnNode * newRevComp = newNode->getReverseComplement();
-        bool revCompSuccess = mergeGraphicsNodes2(revCompOriginalNodes, newRevComp, graph, scene);
-        if (revCompSuccess)
-            newRevComp->setAsDrawn();
+    addMergedGraphicsNodes(originalNodes, revCompOriginalNodes, newNode, scene);
+    BandageGraphicsScene::removeGraphicsItemNodes(originalNodes, true);
+    addMergedGraphicsEdges(newNode, graph, scene);
+}
+
+//Returns the only edge leaving (or entering) the node, or nullptr if there are
+//none or several of them.
+static DeBruijnEdge *getOnlyLeavingEdge(const DeBruijnNode *node) {
+    DeBruijnEdge *onlyEdge = nullptr;
+    for (auto *edge : node->edges()) {
+        if (edge->getStartingNode() != node)
+            continue;
+        if (onlyEdge != nullptr)
+            return nullptr;
+        onlyEdge = edge;
     }
+    return onlyEdge;
+}
 
-    BandageGraphicsScene::removeGraphicsItemNodes(originalNodes, true);
+static DeBruijnEdge *getOnlyEnteringEdge(const DeBruijnNode *node) {
+    DeBruijnEdge *onlyEdge = nullptr;
+    for (auto *edge : node->edges()) {
+        if (edge->getEndingNode() != node)
+            continue;
+        if (onlyEdge != nullptr)
+            return nullptr;
+        onlyEdge = edge;
+    }
+    return onlyEdge;
+}
+
+namespace {
+struct NodeMerge {
+    std::vector<DeBruijnNode *> nodes;
+    Sequence sequence;
+    double depth = 0.0;
+    DeBruijnNode *posNode = nullptr;
+};
+
+//Where an original node ended up after the merge
+struct MergedPosition {
+    DeBruijnNode *node = nullptr;
+    size_t index = 0;  // of the original node in the chain
+    int offset = 0;    // of the original node start in the merged node
+};
+using MergedPositions = phmap::flat_hash_map<const DeBruijnNode *, MergedPosition>;
+}
+
+//Rewrites a path over the original nodes in terms of the merged nodes.  A
+//consecutive run through a chain becomes a single visit of the merged node.
+static Path remapMergedPath(const Path &path, const MergedPositions &positions) {
+    if (path.isEmpty())
+        return path;
+
+    const auto &originalNodes = path.nodes();
+    auto isContinuation = [&](size_t i) {
+        auto cur = positions.find(originalNodes[i]);
+        auto prev = positions.find(originalNodes[(i + originalNodes.size() - 1) % originalNodes.size()]);
+        return cur != positions.end() && prev != positions.end() &&
+               cur->second.node == prev->second.node && prev->second.index + 1 == cur->second.index;
+    };
+
+    //A circular path should not start in the middle of a chain
+    bool circular = path.isCircular();
+    size_t first = 0;
+    if (circular) {
+        while (first < originalNodes.size() && isContinuation(first))
+            ++first;
+        if (first == originalNodes.size())
+            first = 0;
+    }
+
+    std::vector<DeBruijnNode *> nodes;
+    for (size_t j = 0; j < originalNodes.size(); ++j) {
+        size_t i = (first + j) % originalNodes.size();
+        auto it = positions.find(originalNodes[i]);
+        if (it == positions.end())
+            nodes.push_back(originalNodes[i]);
+        else if (j == 0 || !isContinuation(i))
+            nodes.push_back(it->second.node);
+    }
+
+    Path res = Path::makeFromOrderedNodes(nodes, circular);
+    if (res.isEmpty() || circular)
+        return res;
+
+    //Keep the linear path starting and ending at the same bases
+    GraphLocation start = path.getStartLocation(), end = path.getEndLocation();
+    int fromStart = start.getPosition() - 1;
+    int fromEnd = end.getNode()->getLength() - end.getPosition();
+    if (auto it = positions.find(start.getNode()); it != positions.end())
+        fromStart += it->second.offset;
+    if (auto it = positions.find(end.getNode()); it != positions.end())
+        fromEnd += it->second.node->getLength() - it->second.offset - end.getNode()->getLength();
+    res.trim(fromStart, fromEnd);
+
+    return res;
 }
 
 //This function simplifies the graph by merging all possible nodes in a simple
 //line.  It returns the number of merges that it did.
 //It gets a pointer to the progress dialog as well so it can check to see if the
 //user has cancelled the merge.
+//Maximal non-branching chains are found in a single pass over the graph, the
+//merged sequences are built in parallel and then the graph and the scene are
+//updated once for all merges.
 int AssemblyGraph::mergeAllPossible(BandageGraphicsScene * scene,
                                     MyProgressDialog * progressDialog)
 {
-    //Create a set of all nodes.
-    QSet<DeBruijnNode *> uncheckedNodes;
-    for (auto &entry : m_deBruijnGraphNodes) {
-        uncheckedNodes.insert(entry);
-    }
+    //Find all maximal non-branching chains.  Every node is visited once: a
+    //node (and its reverse complement) is marked as soon as it is added to a
+    //chain.
+    std::vector<NodeMerge> allMerges;
+    phmap::flat_hash_set<const DeBruijnNode *> visitedNodes;
+    visitedNodes.reserve(m_deBruijnGraphNodes.size());
+    for (auto *node : m_deBruijnGraphNodes) {
+        if (!visitedNodes.insert(node).second)
+            continue;
+        visitedNodes.insert(node->getReverseComplement());
 
-    //Create a list of all merges to be done.
-    QList< QList<DeBruijnNode *> > allMerges;
-    for (auto &entry : m_deBruijnGraphNodes) {
-        DeBruijnNode * node = entry;
+        std::deque<DeBruijnNode *> nodesToMerge{node};
 
-        //If the current node isn't checked, then we will find the longest
-        //possible mergable sequence containing this node.
-        if (uncheckedNodes.contains(node))
-        {
-            QList<DeBruijnNode *> nodesToMerge;
-            nodesToMerge.push_back(node);
+        //Extend forward as much as possible.
+        while (auto *edge = getOnlyLeavingEdge(nodesToMerge.back())) {
+            DeBruijnNode * potentialNode = edge->getEndingNode();
+            if (getOnlyEnteringEdge(potentialNode) != edge ||
+                visitedNodes.contains(potentialNode))
+                break;
 
-            uncheckedNodes.remove(node);
-            uncheckedNodes.remove(node->getReverseComplement());
+            nodesToMerge.push_back(potentialNode);
+            visitedNodes.insert(potentialNode);
+            visitedNodes.insert(potentialNode->getReverseComplement());
+        }
 
-            //Extend forward as much as possible.
-            bool extended;
-            do
-            {
-                extended = false;
-                DeBruijnNode * last = nodesToMerge.back();
-                std::vector<DeBruijnEdge *> outgoingEdges = last->getLeavingEdges();
-                if (outgoingEdges.size() == 1)
-                {
-                    DeBruijnEdge * potentialEdge = outgoingEdges[0];
-                    DeBruijnNode * potentialNode = potentialEdge->getEndingNode();
-                    std::vector<DeBruijnEdge *> edgesEnteringPotentialNode = potentialNode->getEnteringEdges();
-                    if (edgesEnteringPotentialNode.size() == 1 &&
-                            edgesEnteringPotentialNode[0] == potentialEdge &&
-                            !nodesToMerge.contains(potentialNode) &&
-                            uncheckedNodes.contains(potentialNode))
-                    {
-                        nodesToMerge.push_back(potentialNode);
-                        uncheckedNodes.remove(potentialNode);
-                        uncheckedNodes.remove(potentialNode->getReverseComplement());
-                        extended = true;
-                    }
-                }
-            } while (extended);
+        //Extend backward as much as possible.
+        while (auto *edge = getOnlyEnteringEdge(nodesToMerge.front())) {
+            DeBruijnNode * potentialNode = edge->getStartingNode();
+            if (getOnlyLeavingEdge(potentialNode) != edge ||
+                visitedNodes.contains(potentialNode))
+                break;
 
-            //Extend backward as much as possible.
-            do
-            {
-                extended = false;
-                DeBruijnNode * first = nodesToMerge.front();
-                std::vector<DeBruijnEdge *> incomingEdges = first->getEnteringEdges();
-                if (incomingEdges.size() == 1)
-                {
-                    DeBruijnEdge * potentialEdge = incomingEdges[0];
-                    DeBruijnNode * potentialNode = potentialEdge->getStartingNode();
-                    std::vector<DeBruijnEdge *> edgesLeavingPotentialNode = potentialNode->getLeavingEdges();
-                    if (edgesLeavingPotentialNode.size() == 1 &&
-                            edgesLeavingPotentialNode[0] == potentialEdge &&
-                            !nodesToMerge.contains(potentialNode) &&
-                            uncheckedNodes.contains(potentialNode))
-                    {
-                        nodesToMerge.push_front(potentialNode);
-                        uncheckedNodes.remove(potentialNode);
-                        uncheckedNodes.remove(potentialNode->getReverseComplement());
-                        extended = true;
-                    }
-                }
-            } while (extended);
+            nodesToMerge.push_front(potentialNode);
+            visitedNodes.insert(potentialNode);
+            visitedNodes.insert(potentialNode->getReverseComplement());
+        }
 
-            if (nodesToMerge.size() > 1)
-                allMerges.push_back(nodesToMerge);
+        if (nodesToMerge.size() > 1) {
+            auto &merge = allMerges.emplace_back();
+            merge.nodes.assign(nodesToMerge.begin(), nodesToMerge.end());
         }
     }
 
-    //Now do the actual merges.
     QApplication::processEvents();
     emit setMergeTotalCount(allMerges.size());
-    for (int i = 0; i < allMerges.size(); ++i)
-    {
-        if (progressDialog != nullptr && progressDialog->wasCancelled())
-            break;
 
-        mergeNodes(allMerges[i], scene);
-        emit setMergeCompletedCount(i+1);
-        QApplication::processEvents();
+    //Merged sequences and depths only depend on the original nodes, so they
+    //could be built in parallel.
+    QtConcurrent::blockingMap(allMerges, [](NodeMerge &merge) {
+        merge.sequence = Sequence{Path::makeFromOrderedNodes(merge.nodes, false).getPathSequence()};
+        merge.depth = AssemblyGraph::getMeanDepth(merge.nodes);
+    });
+
+    if (progressDialog != nullptr && progressDialog->wasCancelled())
+        return 0;
+
+    //Create the merged nodes.  Chain ends are mapped to the merged nodes, so
+    //edges could be reconnected afterwards.
+    phmap::flat_hash_map<const DeBruijnNode *, DeBruijnNode *> chainStarts, chainEnds;
+    MergedPositions mergedPositions;
+    std::vector<DeBruijnNode *> allOriginalNodes;
+    for (size_t i = 0; i < allMerges.size(); ++i) {
+        auto &merge = allMerges[i];
+        const auto &nodes = merge.nodes;
+
+        QString newNodeBaseName;
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            newNodeBaseName += nodes[j]->getNameWithoutSign();
+            if (j < nodes.size() - 1)
+                newNodeBaseName += "_";
+        }
+        newNodeBaseName = getUniqueNodeName(newNodeBaseName);
+        QString newPosNodeName = newNodeBaseName + "+";
+        QString newNegNodeName = newNodeBaseName + "-";
+
+        // The negative node is a view of the positive node sequence
+        Sequence negSequence = merge.sequence.GetReverseComplement();
+        auto newPosNode = createNode(newPosNodeName, merge.depth, merge.sequence);
+        auto newNegNode = createNode(newNegNodeName, merge.depth, negSequence);
+
+        newPosNode->setReverseComplement(newNegNode);
+        newNegNode->setReverseComplement(newPosNode);
+
+        m_deBruijnGraphNodes.emplace(newPosNodeName.toStdString(), newPosNode);
+        m_deBruijnGraphNodes.emplace(newNegNodeName.toStdString(), newNegNode);
+        merge.posNode = newPosNode;
+
+        chainStarts[nodes.front()] = newPosNode;
+        chainEnds[nodes.back()] = newPosNode;
+        chainStarts[nodes.back()->getReverseComplement()] = newNegNode;
+        chainEnds[nodes.front()->getReverseComplement()] = newNegNode;
+
+        int offset = 0;
+        for (size_t j = 0; j < nodes.size(); ++j) {
+            int length = nodes[j]->getLength();
+            mergedPositions[nodes[j]] = { newPosNode, j, offset };
+            mergedPositions[nodes[j]->getReverseComplement()] =
+                    { newNegNode, nodes.size() - 1 - j, newNegNode->getLength() - offset - length };
+            if (j + 1 < nodes.size())
+                offset += length - getOnlyLeavingEdge(nodes[j])->getOverlap();
+        }
+
+        allOriginalNodes.insert(allOriginalNodes.end(), nodes.begin(), nodes.end());
+
+        if (i % 1000 == 0) {
+            emit setMergeCompletedCount(i);
+            QApplication::processEvents();
+        }
+    }
+
+    //Reconnect the merged nodes.  Edges between two chains are seen from both
+    //sides, createDeBruijnEdge ignores the duplicates.  A circular chain
+    //becomes a node with an edge to itself.
+    for (const auto &merge : allMerges) {
+        const auto &nodes = merge.nodes;
+
+        for (auto *leavingEdge : nodes.back()->getLeavingEdges()) {
+            DeBruijnNode *endingNode = leavingEdge->getEndingNode();
+            if (auto it = chainStarts.find(endingNode); it != chainStarts.end())
+                endingNode = it->second;
+            createDeBruijnEdge(merge.posNode->getName(), endingNode->getName(),
+                               leavingEdge->getOverlap(), leavingEdge->getOverlapType());
+        }
+
+        for (auto *enteringEdge : nodes.front()->getEnteringEdges()) {
+            DeBruijnNode *startingNode = enteringEdge->getStartingNode();
+            if (auto it = chainEnds.find(startingNode); it != chainEnds.end())
+                startingNode = it->second;
+            createDeBruijnEdge(startingNode->getName(), merge.posNode->getName(),
+                               enteringEdge->getOverlap(), enteringEdge->getOverlapType());
+        }
+    }
+
+    //Paths and walks through the merged nodes are rewritten, so they do not
+    //refer to the original nodes that are about to be deleted.
+    if (!allMerges.empty()) {
+        graph::PathStore pathStore, walkStore;
+        for (auto it = m_deBruijnGraphPaths.begin(); it != m_deBruijnGraphPaths.end(); ++it)
+            *it = pathStore.add(remapMergedPath(getPath(*it), mergedPositions));
+        for (auto &walk : m_deBruijnGraphWalks)
+            walk.pathId = walkStore.add(remapMergedPath(getWalkPath(walk), mergedPositions));
+        m_pathStore = std::move(pathStore);
+        m_walkStore = std::move(walkStore);
     }
 
+    if (scene != nullptr) {
+        for (const auto &merge : allMerges) {
+            std::vector<DeBruijnNode*> revCompNodes;
+            revCompNodes.reserve(merge.nodes.size());
+            for (auto it = merge.nodes.rbegin(); it != merge.nodes.rend(); ++it)
+                revCompNodes.push_back((*it)->getReverseComplement());
+
+            addMergedGraphicsNodes(merge.nodes, revCompNodes, merge.posNode, scene);
+        }
+
+        BandageGraphicsScene::removeGraphicsItemNodes(allOriginalNodes, true);
+
+        for (const auto &merge : allMerges)
+            addMergedGraphicsEdges(merge.posNode, *this, scene);
+    }
+
+    deleteNodes(allOriginalNodes);
+    buildPathIndices();
+    emit setMergeCompletedCount(allMerges.size());
+
     recalculateAllNodeWidths(g_settings->averageNodeWidth,
                              g_settings->depthPower, g_settings->depthEffectOnWidth);
 
@@ -1396,8 +1653,10 @@ void AssemblyGraph::changeNodeName(const QString& oldName, const QString& newNam
     QString posNewNodeName = newName + "+";
     QString negNewNodeName = newName + "-";
 
-    posNode->setName(posNewNodeName);
-    negNode->setName(negNewNodeName);
+    QByteArray utf8Name = newName.toUtf8();
+    const char *newNodeName = m_nodeNames.intern(std::string_view(utf8Name.constData(), utf8Name.size()));
+    posNode->setName(newNodeName, true);
+    negNode->setName(newNodeName, false);
 
     m_deBruijnGraphNodes.emplace(posNewNodeName.toStdString(), posNode);
     m_deBruijnGraphNodes.emplace(negNewNodeName.toStdString(), negNode);
@@ -1435,6 +1694,7 @@ void AssemblyGraph::changeNodeDepth(const std::vector<DeBruijnNode *> &nodes,
     if (nodes.empty())
         return;
 
+    m_nodeMetrics.clear();
     for (auto node : nodes) {
         node->setDepth(newDepth);
         node->getReverseComplement()->setDepth(newDepth);
@@ -1637,7 +1897,7 @@ long long AssemblyGraph::getEstimatedSequenceLength(double medianDepthByBase) co
 
         if (node->isPositiveNode())
         {
-            int nodeLength = node->getLengthWithoutTrailingOverlap();
+            int nodeLength = m_nodeMetrics.get(node).trimmedLength;
             double relativeDepth = node->getDepth() / medianDepthByBase;
 
             int closestIntegerDepth = round(relativeDepth);
@@ -1699,6 +1959,33 @@ long long AssemblyGraph::getTotalLengthOrphanedNodes() const {
     return total;
 }
 
+// Reports the memory needed for the packed node sequences if every node owned
+// its own buffer and the memory actually used when reverse complement nodes
+// (and subsequences) share the buffer they were created from.
+void AssemblyGraph::getPackedSequenceMemory(size_t * unsharedBytes, size_t * storedBytes) const {
+    *unsharedBytes = *storedBytes = 0;
+
+    phmap::flat_hash_set<const void*> buffers;
+    auto accountSequence = [&](const Sequence &sequence) {
+        // All-N sequences do not store any packed data
+        if (!sequence.missing())
+            *unsharedBytes += sequence.capacity();
+        if (buffers.insert(sequence.buffer()).second)
+            *storedBytes += sequence.bufferCapacity();
+    };
+
+    for (auto &entry : m_deBruijnGraphNodes) {
+        const DeBruijnNode * node = entry;
+        if (!node->isPositiveNode())
+            continue;
+
+        accountSequence(node->getSequence());
+        const DeBruijnNode * rcNode = node->getReverseComplement();
+        if (rcNode && rcNode != node)
+            accountSequence(rcNode->getSequence());
+    }
+}
+
 QStringList AssemblyGraph::getCustomLabelForDisplay(const DeBruijnNode *node) const {
     QStringList customLabelLines;
     QString label = getCustomLabel(node);
@@ -24,6 +24,11 @@
 #include "path.h"
 #include "annotation.h"
 #include "graphscope.h"
+#include "objectarena.h"
+#include "nametable.h"
+#include "pathindex.h"
+#include "pathstore.h"
+#include "nodemetrics.h"
 
 #include "io/gfa.h"
 
@@ -93,11 +98,20 @@ public:
     phmap::parallel_flat_hash_map<const DeBruijnNode*, std::vector<gfa::tag>> m_nodeTags;
     phmap::parallel_flat_hash_map<const DeBruijnEdge*, std::vector<gfa::tag>> m_edgeTags;
 
-    // Paths
-    tsl::htrie_map<char, Path> m_deBruijnGraphPaths;
+    // Paths: name -> id in the path store
+    tsl::htrie_map<char, graph::PathStore::Id> m_deBruijnGraphPaths;
+    graph::PathStore m_pathStore;
 
     // Walks
     tsl::htrie_map<char, Walk> m_deBruijnGraphWalks;
+    graph::PathStore m_walkStore;
+
+    // Node -> paths / walks passing through it
+    graph::PathIndex<decltype(m_deBruijnGraphPaths)> m_pathIndex;
+    graph::PathIndex<decltype(m_deBruijnGraphWalks)> m_walkIndex;
+
+    // Derived per-node metrics, rebuilt by determineGraphInfo()
+    graph::NodeMetricsCache m_nodeMetrics;
 
     int m_nodeCount;
     int m_edgeCount;
@@ -111,10 +125,29 @@ public:
     double m_firstQuartileDepth;
     double m_medianDepth;
     double m_thirdQuartileDepth;
+    double m_loadThroughput; // MB/s, 0 if unknown
     QString m_filename;
     QString m_depthTag;
     SequencesLoadedFromFasta m_sequencesLoadedFromFasta;
 
+    // Nodes and edges are owned by the graph. They are allocated from the
+    // arenas and must be released via destroyNode() / destroyEdge(). Node
+    // names (including the trailing sign) are stored in the graph name table.
+    DeBruijnNode *createNode(std::string_view name,
+                             float depth, const Sequence &sequence, unsigned length = 0);
+    DeBruijnNode *createNode(const QString &name,
+                             float depth, const Sequence &sequence, unsigned length = 0) {
+        QByteArray utf8Name = name.toUtf8();
+        return createNode(std::string_view(utf8Name.constData(), utf8Name.size()), depth, sequence, length);
+    }
+    template<class... Args>
+    DeBruijnEdge *createEdge(Args&&... args) {
+        m_nodeMetrics.clear();
+        return m_edgeArena.create(std::forward<Args>(args)...);
+    }
+    void destroyNode(DeBruijnNode *node) { m_nodeMetrics.clear(); m_nodeArena.destroy(node); }
+    void destroyEdge(DeBruijnEdge *edge) { m_nodeMetrics.clear(); m_edgeArena.destroy(edge); }
+
     void cleanUp();
     void createDeBruijnEdge(const QString& node1Name, const QString& node2Name,
                             int overlap = 0,
@@ -125,6 +158,12 @@ public:
     static double getMeanDepth(const std::vector<DeBruijnNode *> &nodes);
 
     void determineGraphInfo();
+    // Paths and walks with a name already present are ignored
+    bool addPath(std::string_view name, const Path &path);
+    bool addWalk(std::string_view name, Walk walk, const Path &path);
+    [[nodiscard]] Path getPath(graph::PathStore::Id id) const { return m_pathStore.path(id); }
+    [[nodiscard]] Path getWalkPath(const Walk &walk) const { return m_walkStore.path(walk.pathId); }
+    void buildPathIndices();
     void clearGraphInfo();
 
     void recalculateAllNodeWidths(double averageNodeWidth,
@@ -171,6 +210,7 @@ public:
     long long getTotalLengthMinusEdgeOverlaps() const;
     QPair<int, int> getOverlapRange() const;
     long long getTotalLengthOrphanedNodes() const;
+    void getPackedSequenceMemory(size_t * unsharedBytes, size_t * storedBytes) const;
 
     bool hasCustomColour(const DeBruijnNode* node) const;
     bool hasCustomColour(const DeBruijnEdge* edge) const;
@@ -202,6 +242,10 @@ public:
 
     std::vector<DeBruijnNode *> getNodesInDepthRange(double min, double max) const;
 private:
+    graph::ObjectArena<DeBruijnNode> m_nodeArena;
+    graph::ObjectArena<DeBruijnEdge> m_edgeArena;
+    graph::NameTable m_nodeNames;
+
     std::vector<DeBruijnNode *> getNodesFromListExact(const QStringList& nodesList, std::vector<QString> * nodesNotInGraph) const;
     std::vector<DeBruijnNode *> getNodesFromListPartial(const QStringList& nodesList, std::vector<QString> * nodesNotInGraph) const;
     std::vector<int> makeOverlapCountVector();
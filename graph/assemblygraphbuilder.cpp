@@ -24,6 +24,7 @@
 
 #include "io/gfa.h"
 #include "io/fileutils.h"
+#include "io/linereader.h"
 
 #include "seq/sequence.hpp"
 #include <llvm/Support/Error.h>
@@ -33,14 +34,14 @@
 #include <QDir>
 #include <QString>
 #include <QRegularExpression>
-#include <memory>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
 
-#include <zlib.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
 
-#if defined(_MSC_VER)
-#include <BaseTsd.h>
-typedef SSIZE_T ssize_t;
-#endif
 
 static bool checkFirstLineOfFile(const QString& fullFileName, const QString& regExp) {
     QFile inputFile(fullFileName);
@@ -88,62 +89,59 @@ static bool checkFileIsAsqg(const QString& fullFileName) {
     return checkFirstLineOfFile(fullFileName, "^HT\t");
 }
 
-static ssize_t gzgetdelim(char **buf, size_t *bufsiz, int delimiter, gzFile fp) {
-    char *ptr, *eptr;
-
-    if (*buf == NULL || *bufsiz == 0) {
-        *bufsiz = BUFSIZ;
-        if ((*buf = (char*)malloc(*bufsiz)) == NULL)
-            return -1;
+namespace {
+// A chunk of the input together with the records parsed from its lines
+struct GFAChunk {
+    io::LineChunk data;
+    std::vector<std::optional<gfa::record>> records;
+};
+
+// Record types handled by a loading pass
+enum class GFAPass {
+    All,
+    Segments,
+    Rest
+};
+
+bool isPassRecord(std::string_view line, GFAPass pass) {
+    switch (pass) {
+        case GFAPass::All:
+            return true;
+        case GFAPass::Segments:
+            return line.front() == 'S';
+        case GFAPass::Rest:
+            return line.front() != 'S';
     }
 
-    for (ptr = *buf, eptr = *buf + *bufsiz;;) {
-        char c = gzgetc(fp);
-        if (c == -1) {
-            if (gzeof(fp)) {
-                ssize_t diff = (ssize_t) (ptr - *buf);
-                if (diff != 0) {
-                    *ptr = '\0';
-                    return diff;
-                }
-            }
-            return -1;
-        }
-        *ptr++ = c;
-        if (c == delimiter) {
-            *ptr = '\0';
-            return ptr - *buf;
-        }
-        if (ptr + 2 >= eptr) {
-            char *nbuf;
-            size_t nbufsiz = *bufsiz * 2;
-            ssize_t d = ptr - *buf;
-            if ((nbuf = (char*)realloc(*buf, nbufsiz)) == NULL)
-                return -1;
-
-            *buf = nbuf;
-            *bufsiz = nbufsiz;
-            eptr = nbuf + nbufsiz;
-            ptr = nbuf + d;
-        }
-    }
+    return true;
 }
 
-static ssize_t gzgetline(char **buf, size_t *bufsiz, gzFile fp) {
-    ssize_t read = gzgetdelim(buf, bufsiz, '\n', fp);
-    // Very big hammer to handle CRLF line endings: if the last symbol of a line
-    // is CR, then replace it with 0
-    if (read >= 2) {
-        char *last = *buf + read - 2;
-        if (*last == '\r') {
-            *last = '\0';
-            read -= 1;
+// Parses all lines of the chunk that belong to the pass, in parallel if the
+// thread pool is provided
+void parseChunk(GFAChunk &chunk, GFAPass pass, QThreadPool *pool) {
+    const auto &lines = chunk.data.lines;
+    chunk.records.assign(lines.size(), std::nullopt);
+    auto parseRange = [&chunk, &lines, pass](std::pair<size_t, size_t> range) {
+        for (size_t i = range.first; i < range.second; ++i) {
+            if (isPassRecord(lines[i], pass))
+                chunk.records[i] = gfa::parseRecord(lines[i].data(), lines[i].size());
         }
+    };
+
+    if (!pool) {
+        parseRange({0, lines.size()});
+        return;
     }
 
-    return read;
-}
+    // Parse lines in batches to amortize the scheduling overhead
+    constexpr size_t BatchSize = 1024;
+    std::vector<std::pair<size_t, size_t>> batches;
+    for (size_t i = 0; i < lines.size(); i += BatchSize)
+        batches.emplace_back(i, std::min(i + BatchSize, lines.size()));
 
+    QtConcurrent::blockingMap(pool, batches, parseRange);
+}
+}
 
 static std::string getOppositeNodeName(std::string nodeName) {
     return (nodeName.back() == '-' ?
@@ -326,7 +324,7 @@ namespace io {
                 return placeholder;
             }
 
-            return (graph.m_deBruijnGraphNodes[nodeName] = new DeBruijnNode(nodeName.c_str(), nodeDepth, sequence));
+            return (graph.m_deBruijnGraphNodes[nodeName] = graph.createNode(nodeName, nodeDepth, sequence));
         }
 
         using NodePair = std::pair<DeBruijnNode*, DeBruijnNode*>;
@@ -486,7 +484,7 @@ namespace io {
                 return nodeOrErr.takeError();
 
             DeBruijnEdge *edgePtr = nullptr, *rcEdgePtr = nullptr;
-            edgePtr = new DeBruijnEdge(fromNodePtr, toNodePtr);
+            edgePtr = graph.createEdge(fromNodePtr, toNodePtr);
 
             bool isOwnPair = fromNodePtr == toNodePtr->getReverseComplement() &&
                              toNodePtr == fromNodePtr->getReverseComplement();
@@ -499,7 +497,7 @@ namespace io {
             } else {
                 auto *rcFromNodePtr = fromNodePtr->getReverseComplement();
                 auto *rcToNodePtr = toNodePtr->getReverseComplement();
-                rcEdgePtr = new DeBruijnEdge(rcToNodePtr, rcFromNodePtr);
+                rcEdgePtr = graph.createEdge(rcToNodePtr, rcFromNodePtr);
                 rcFromNodePtr->addEdge(rcEdgePtr);
                 rcToNodePtr->addEdge(rcEdgePtr);
                 edgePtr->setReverseComplement(rcEdgePtr);
@@ -603,7 +601,7 @@ namespace io {
                                                + record.name + "', cannot reconstruct path through the graph");
             }
 
-            graph.m_deBruijnGraphPaths.emplace(record.name, std::move(p));
+            graph.addPath(record.name, p);
 
             return llvm::Error::success();
         }
@@ -645,10 +643,85 @@ namespace io {
             unsigned seqStart = record.SeqStart ? *record.SeqStart : 0;
             unsigned seqEnd = record.SeqEnd ? *record.SeqEnd : len;
 
-            graph.m_deBruijnGraphWalks.emplace(record.SeqId,
-                                               Walk{std::string(record.SampleId),
-                                                   seqStart, seqEnd, record.HapIndex,
-                                                   std::move(p)});
+            graph.addWalk(record.SeqId,
+                          Walk{std::string(record.SampleId),
+                               seqStart, seqEnd, record.HapIndex, 0},
+                          p);
+
+            return llvm::Error::success();
+        }
+
+        // Reads the whole input and adds the records that belong to the pass
+        // to the graph. The number of links (L and J records) is returned via
+        // linkCount, if requested.
+        llvm::Error loadRecords(io::LineReader &reader, QThreadPool *pool,
+                                GFAPass pass,
+                                AssemblyGraph &graph,
+                                bool &sequencesAreMissing,
+                                size_t *linkCount = nullptr) {
+            // The loading is staged: while the records of the current chunk are
+            // added to the graph (this is inherently sequential), the next chunk
+            // is read and parsed by the thread pool.
+            auto fetch = [&](GFAChunk &chunk) {
+                if (!reader.read(chunk.data))
+                    return false;
+                parseChunk(chunk, pass, pool);
+                return true;
+            };
+
+            GFAChunk current, next;
+            bool hasChunk = fetch(current);
+            while (hasChunk) {
+                QFuture<bool> prefetch;
+                if (pool)
+                    prefetch = QtConcurrent::run(pool, [&]() { return fetch(next); });
+
+                if (linkCount) {
+                    for (const auto &line : current.data.lines)
+                        *linkCount += line.front() == 'L' || line.front() == 'J';
+                }
+
+                for (const auto &result : current.records) {
+                    if (!result)
+                        continue;
+
+                    llvm::Error E =
+                            std::visit([&](const auto &record) {
+                                   using T = std::decay_t<decltype(record)>;
+                                   if constexpr (std::is_same_v<T, gfa::segment>) {
+                                       if (auto valueOrError = handleSegment(record, graph))
+                                           sequencesAreMissing |= *valueOrError;
+                                       else
+                                           return valueOrError.takeError();
+                                   } else if constexpr (std::is_same_v<T, gfa::link>) {
+                                       if (auto E = handleLink(record, graph))
+                                           return E;
+                                   } else if constexpr (std::is_same_v<T, gfa::gaplink>) {
+                                       if (auto E = handleGapLink(record, graph, jumpsAsLinks_))
+                                           return E;
+                                   } else if constexpr (std::is_same_v<T, gfa::path>) {
+                                       if (auto E = handlePath(record, graph))
+                                           return E;
+                                   } else if constexpr (std::is_same_v<T, gfa::walk>) {
+                                       if (auto E = handleWalk(record, graph))
+                                           return E;
+                                   }
+                                   return llvm::Error(llvm::Error::success());
+                               },
+                               *result);
+                    if (E) {
+                        // Wait for the prefetch as it refers to the local state
+                        prefetch.waitForFinished();
+                        return E;
+                    }
+                }
+
+                hasChunk = pool ? prefetch.result() : fetch(next);
+                std::swap(current, next);
+            }
+
+            if (reader.error())
+                return llvm::createStringError("failed to read file: " + fileName_.toStdString());
 
             return llvm::Error::success();
         }
@@ -661,51 +734,48 @@ namespace io {
 
             bool sequencesAreMissing = false;
 
-            std::unique_ptr<std::remove_pointer<gzFile>::type, decltype(&gzclose)>
-                    fp(gzopen(fileName_.toStdString().c_str(), "r"), gzclose);
-            if (!fp)
+            auto start = std::chrono::steady_clock::now();
+
+            std::unique_ptr<io::LineReader> reader = io::LineReader::open(fileName_);
+            if (!reader)
                 return llvm::createStringError("failed to open file: " + fileName_.toStdString());
 
-            size_t i = 0;
-            char *line = nullptr;
-            size_t len = 0;
-            ssize_t read;
-            while ((read = gzgetline(&line, &len, fp.get())) != -1) {
-                if (read <= 1)
-                    continue; // skip empty lines
-
-                auto result = gfa::parseRecord(line, read - 1);
-                if (!result)
-                    continue;
-
-                llvm::Error E =
-                        std::visit([&](const auto &record) {
-                               using T = std::decay_t<decltype(record)>;
-                               if constexpr (std::is_same_v<T, gfa::segment>) {
-                                   if (auto valueOrError = handleSegment(record, graph))
-                                       sequencesAreMissing |= *valueOrError;
-                                   else
-                                       return valueOrError.takeError();
-                               } else if constexpr (std::is_same_v<T, gfa::link>) {
-                                   if (auto E = handleLink(record, graph))
-                                       return E;
-                               } else if constexpr (std::is_same_v<T, gfa::gaplink>) {
-                                   if (auto E = handleGapLink(record, graph, jumpsAsLinks_))
-                                       return E;
-                               } else if constexpr (std::is_same_v<T, gfa::path>) {
-                                   if (auto E = handlePath(record, graph))
-                                       return E;
-                               } else if constexpr (std::is_same_v<T, gfa::walk>) {
-                                   if (auto E = handleWalk(record, graph))
-                                       return E;
-                               }
-                               return llvm::Error(llvm::Error::success());
-                           },
-                           *result);
-                if (E)
+            unsigned threads = threads_ ? threads_ : QThread::idealThreadCount();
+            std::unique_ptr<QThreadPool> pool;
+            if (threads > 1) {
+                pool = std::make_unique<QThreadPool>();
+                pool->setMaxThreadCount(int(threads));
+            }
+
+            if (twoPass_) {
+                // First pass: create all segments and count the links, so the
+                // second pass never needs to create placeholder nodes and the edge
+                // table could be sized upfront
+                size_t linkCount = 0;
+                if (auto E = loadRecords(*reader, pool.get(), GFAPass::Segments,
+                                         graph, sequencesAreMissing, &linkCount))
                     return E;
+
+                // Report the input size rather than the bytes read by both passes
+                bytesProcessed_ = reader->bytesRead();
+                if (!reader->rewind())
+                    return llvm::createStringError("failed to read file: " + fileName_.toStdString());
+
+                // Each link is normally accompanied by its reverse-complement
+                graph.m_deBruijnGraphEdges.reserve(graph.m_deBruijnGraphEdges.size() + 2 * linkCount);
+
+                if (auto E = loadRecords(*reader, pool.get(), GFAPass::Rest,
+                                         graph, sequencesAreMissing))
+                    return E;
+            } else {
+                if (auto E = loadRecords(*reader, pool.get(), GFAPass::All,
+                                         graph, sequencesAreMissing))
+                    return E;
+                bytesProcessed_ = reader->bytesRead();
             }
 
+            elapsed_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
             graph.m_sequencesLoadedFromFasta = NOT_TRIED;
             if (sequencesAreMissing)
                 attemptToLoadSequencesFromFasta(graph);
@@ -721,20 +791,43 @@ namespace io {
                 continue;
 
             if (DeBruijnNode *negativeNode =
-                    graph.m_deBruijnGraphNodes[getOppositeNodeName(positiveNode->getName().toStdString())]) {
+                    graph.m_deBruijnGraphNodes[getOppositeNodeName(positiveNode->getStdName())]) {
                 positiveNode->setReverseComplement(negativeNode);
                 negativeNode->setReverseComplement(positiveNode);
             }
         }
     }
 
+    // Formats like FASTG store both strands explicitly. Make negative nodes views
+    // of the positive node sequences, so only one packed buffer per pair is kept.
+    static void shareReverseComplementSequences(AssemblyGraph &graph) {
+        for (auto &entry: graph.m_deBruijnGraphNodes) {
+            DeBruijnNode *positiveNode = entry;
+            if (!positiveNode->isPositiveNode() || positiveNode->sequenceIsMissing())
+                continue;
+
+            DeBruijnNode *negativeNode = positiveNode->getReverseComplement();
+            if (!negativeNode || negativeNode == positiveNode ||
+                negativeNode->getSequence().size() != positiveNode->getSequence().size())
+                continue;
+
+            // The file stores both strands, only share the buffer if the stored
+            // copy really is the reverse complement, otherwise keep it as-is
+            Sequence reverseComplement = positiveNode->getSequence().GetReverseComplement();
+            if (reverseComplement != negativeNode->getSequence())
+                continue;
+
+            negativeNode->setSequence(reverseComplement);
+        }
+    }
+
     static void makeReverseComplementNodeIfNecessary(AssemblyGraph &graph, DeBruijnNode *node) {
-        auto reverseComplementName = getOppositeNodeName(node->getName().toStdString());
+        auto reverseComplementName = getOppositeNodeName(node->getStdName());
         if (!graph.m_deBruijnGraphNodes.count(reverseComplementName)) {
             Sequence nodeSequence{};
             if (!node->sequenceIsMissing())
                 nodeSequence = node->getSequence();
-            auto newNode = new DeBruijnNode(reverseComplementName.c_str(), node->getDepth(),
+            auto newNode = graph.createNode(reverseComplementName, node->getDepth(),
                                             nodeSequence.GetReverseComplement(),
                                             node->getLength());
             graph.m_deBruijnGraphNodes.emplace(reverseComplementName, newNode);
@@ -826,7 +919,7 @@ namespace io {
                 if (name.length() < 1)
                     return llvm::createStringError("load error");
 
-                auto node = new DeBruijnNode(name, depth, sequence);
+                auto node = graph.createNode(name, depth, sequence);
                 graph.m_deBruijnGraphNodes.emplace(name.toStdString(), node);
                 makeReverseComplementNodeIfNecessary(graph, node);
             }
@@ -899,7 +992,7 @@ namespace io {
                         nodeDepth = nodeDepthString.toDouble();
 
                         //Make the node
-                        node = new DeBruijnNode(nodeName, nodeDepth,
+                        node = graph.createNode(nodeName, nodeDepth,
                                                 {}); //Sequence string is currently empty - will be added to on subsequent lines of the fastg file
                         graph.m_deBruijnGraphNodes.emplace(nodeName.toStdString(), node);
 
@@ -950,7 +1043,7 @@ namespace io {
                     std::vector<DeBruijnNode *> nodes;
                     for (const auto &entry: graph.m_deBruijnGraphNodes) {
                         DeBruijnNode *node = entry;
-                        if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getName().toStdString())))
+                        if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getStdName())))
                             nodes.emplace_back(node);
                     }
 
@@ -958,7 +1051,7 @@ namespace io {
                         makeReverseComplementNodeIfNecessary(graph, entry);
                 }
                 pointEachNodeToItsReverseComplement(graph);
-
+                shareReverseComplementSequences(graph);
 
                 //Create all of the edges.
                 for (size_t i = 0; i < edgeStartingNodeNames.size(); ++i) {
@@ -1022,7 +1115,7 @@ namespace io {
                         // ASQG files don't seem to include depth, so just set this to one for every node.
                         double nodeDepth = 1.0;
 
-                        auto node = new DeBruijnNode(nodeName, nodeDepth, sequence, length);
+                        auto node = graph.createNode(nodeName, nodeDepth, sequence, length);
                         graph.m_deBruijnGraphNodes.emplace(nodeName.toStdString(), node);
                     }
                         // Lines beginning with "ED" are edge lines
@@ -1089,7 +1182,7 @@ namespace io {
                     std::vector<DeBruijnNode *> nodes;
                     for (const auto &entry: graph.m_deBruijnGraphNodes) {
                         DeBruijnNode *node = entry;
-                        if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getName().toStdString())))
+                        if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getStdName())))
                             nodes.emplace_back(node);
                     }
 
@@ -1206,7 +1299,7 @@ namespace io {
 
                         Sequence nodeSequence = sequence.Subseq(nodeRangeStart, nodeRangeEnd + 1);
 
-                        auto node = new DeBruijnNode(nodeName, 1.0, nodeSequence);
+                        auto node = graph.createNode(nodeName, 1.0, nodeSequence);
                         graph.m_deBruijnGraphNodes.emplace(nodeName.toStdString(), node);
                     }
 
@@ -1225,7 +1318,7 @@ namespace io {
                 std::vector<DeBruijnNode *> nodes;
                 for (const auto &entry: graph.m_deBruijnGraphNodes) {
                     DeBruijnNode *node = entry;
-                    if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getName().toStdString())))
+                    if (!graph.m_deBruijnGraphNodes.count(getOppositeNodeName(node->getStdName())))
                         nodes.emplace_back(node);
                 }
 
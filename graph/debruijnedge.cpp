@@ -22,6 +22,7 @@
 #include "program/settings.h"
 
 #include <cmath>
+#include <vector>
 #include <QApplication>
 
 DeBruijnEdge::DeBruijnEdge(DeBruijnNode *startingNode, DeBruijnNode *endingNode) :
@@ -86,7 +87,7 @@ bool DeBruijnEdge::isPositiveEdge() const
     //negative.  In this case, just choose the one with the first name
     //alphabetically - an arbitrary choice, but at least it is
     //consistent.
-    return (m_startingNode->getName() > m_reverseComplement->m_startingNode->getName());
+    return (m_startingNode->getStdName() > m_reverseComplement->m_startingNode->getStdName());
 }
 
 
@@ -275,29 +276,89 @@ void DeBruijnEdge::autoDetermineExactOverlap()
     m_overlap = 0;
     m_overlapType = AUTO_DETERMINED_EXACT_OVERLAP;
 
-    //Find an appropriate search range
+    int min, max;
+    if (!getExactOverlapSearchRange(&min, &max))
+        return;
+
+    //We don't want the search to be biased towards larger or smaller
+    //overlaps, so start with a pseudorandom value and loop.
+    int firstOverlap = min + (rand() % (max - min + 1));
+    m_overlap = findExactOverlap(min, max, firstOverlap);
+}
+
+//This function finds an appropriate range of overlaps to search.  It returns
+//false if the nodes are too short for any overlap in the settings.
+bool DeBruijnEdge::getExactOverlapSearchRange(int * min, int * max) const
+{
     int minPossibleOverlap = std::min(m_startingNode->getLength(), m_endingNode->getLength());
     if (minPossibleOverlap < g_settings->minAutoFindEdgeOverlap)
+        return false;
+
+    *min = std::min(minPossibleOverlap, g_settings->minAutoFindEdgeOverlap);
+    *max = std::min(minPossibleOverlap, g_settings->maxAutoFindEdgeOverlap);
+    return true;
+}
+
+//Computes the Z-array of s: z[i] is the length of the longest common prefix
+//of s and its suffix starting at i.
+static void computeZArray(const std::vector<char> &s, std::vector<size_t> &z)
+{
+    size_t n = s.size();
+    z.assign(n, 0);
+    if (n == 0)
         return;
-    int min = std::min(minPossibleOverlap, g_settings->minAutoFindEdgeOverlap);
-    int max = std::min(minPossibleOverlap, g_settings->maxAutoFindEdgeOverlap);
 
-    //Try each overlap in the range and set the first one found.
-    //However, we don't want the search to be biased towards larger
-    //or smaller overlaps, so start with a pseudorandom value and loop.
-    int testOverlap = min + (rand() % (max - min + 1));
-    for (int i = min; i <= max; ++i)
+    z[0] = n;
+    for (size_t i = 1, l = 0, r = 0; i < n; ++i)
     {
-        if (testExactOverlap(testOverlap))
+        if (i < r)
+            z[i] = std::min(r - i, z[i - l]);
+        while (i + z[i] < n && s[z[i]] == s[i + z[i]])
+            ++z[i];
+        if (i + z[i] > r)
         {
-            m_overlap = testOverlap;
-            return;
+            l = i;
+            r = i + z[i];
         }
+    }
+}
 
-        ++testOverlap;
-        if (testOverlap > max)
-            testOverlap = min;
+//This function returns the first overlap in [min, max] that works perfectly,
+//trying them in order from firstOverlap and wrapping around to min.  It returns
+//0 if none of them works.
+//All candidates are tested in a single linear pass: in the string made of the
+//first max bases of the ending node, a separator and the last max bases of the
+//starting node, an overlap of k works exactly when the last k characters are
+//also a prefix of the string.
+int DeBruijnEdge::findExactOverlap(int min, int max, int firstOverlap) const
+{
+    if (max < min)
+        return 0;
+
+    std::vector<char> s;
+    s.reserve(2 * size_t(max) + 1);
+    for (int i = 0; i < max; ++i)
+        s.push_back(m_endingNode->getBaseAt(i));
+    s.push_back('$');
+    int startingNodeLength = m_startingNode->getLength();
+    for (int i = startingNodeLength - max; i < startingNodeLength; ++i)
+        s.push_back(m_startingNode->getBaseAt(i));
+
+    std::vector<size_t> z;
+    computeZArray(s, z);
+
+    int overlap = firstOverlap;
+    for (int i = min; i <= max; ++i)
+    {
+        if (overlap == 0 || z[s.size() - overlap] >= size_t(overlap))
+            return overlap;
+
+        ++overlap;
+        if (overlap > max)
+            overlap = min;
     }
+
+    return 0;
 }
 
 
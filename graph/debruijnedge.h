@@ -63,6 +63,8 @@ public:
     EdgeOverlapType getOverlapType() const {return m_overlapType;}
     DeBruijnNode * getOtherNode(const DeBruijnNode * node) const;
     bool testExactOverlap(int overlap) const;
+    bool getExactOverlapSearchRange(int * min, int * max) const;
+    int findExactOverlap(int min, int max, int firstOverlap) const;
     void tracePaths(bool forward,
                     int stepsRemaining,
                     std::vector<std::vector<DeBruijnNode *> > &allPaths,
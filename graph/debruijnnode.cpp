@@ -35,12 +35,13 @@
 
 //The length parameter is optional.  If it is set, then the node will use that
 //for its length.  If not set, it will just use the sequence length.
-DeBruijnNode::DeBruijnNode(QString name, float depth, const Sequence& sequence, unsigned length)
-        : m_name(std::move(name)),
+DeBruijnNode::DeBruijnNode(const char *name, bool positive, float depth, const Sequence& sequence, unsigned length)
+        : m_name(name),
           m_depth(depth),
           m_sequence(sequence),
           m_reverseComplement(nullptr),
           m_graphicsItemNode(nullptr),
+          m_positive(positive),
           m_specialNode(false),
           m_drawn(false) {
     m_length = length > 0 ? length : sequence.size();
@@ -167,7 +168,9 @@ QByteArray DeBruijnNode::getNodeNameForFasta(bool sign) const
     QByteArray nodeNameForFasta;
 
     nodeNameForFasta += "NODE_";
-    nodeNameForFasta += sign ? qPrintable(getName()) : qPrintable(getNameWithoutSign());
+    nodeNameForFasta += m_name;
+    if (sign)
+        nodeNameForFasta += m_positive ? '+' : '-';
 
     nodeNameForFasta += "_length_";
     nodeNameForFasta += QByteArray::number(getLength());
@@ -205,20 +208,6 @@ void DeBruijnNode::labelNeighbouringNodesAsDrawn(int nodeDistance) {
     }
 }
 
-bool DeBruijnNode::isPositiveNode() const
-{
-    QChar lastChar = m_name.at(m_name.length() - 1);
-    return lastChar == '+';
-}
-
-
-bool DeBruijnNode::isNegativeNode() const
-{
-    QChar lastChar = m_name.at(m_name.length() - 1);
-    return lastChar == '-';
-}
-
-
 //This function checks to see if the passed node leads into
 //this node.  If so, it returns the connecting edge.  If not,
 //it returns a null pointer.
@@ -374,11 +363,5 @@ std::vector<DeBruijnNode *> DeBruijnNode::getAllConnectedPositiveNodes() const
 }
 
 float DeBruijnNode::getGC() const {
-    size_t gc = 0;
-    for (size_t i = 0; i < m_sequence.size(); ++i) {
-        char c = m_sequence[i];
-        gc += (c == 'G' || c == 'C');
-    }
-
-    return float(gc) / float(m_sequence.size());
+    return float(m_sequence.gcCount()) / float(m_sequence.size());
 }
@@ -23,6 +23,9 @@
 
 #include <QColor>
 #include <QByteArray>
+#include <QString>
+#include <string>
+#include <string_view>
 #include <vector>
 
 class DeBruijnEdge;
@@ -32,13 +35,17 @@ class DeBruijnNode
 {
 public:
     //CREATORS
-    DeBruijnNode(QString name, float depth, const Sequence &sequence, unsigned length = 0);
+    // The name is not owned by the node and must outlive it (see AssemblyGraph::createNode)
+    DeBruijnNode(const char *name, bool positive, float depth, const Sequence &sequence, unsigned length = 0);
     ~DeBruijnNode() = default;
 
     //ACCESSORS
-    QString getName() const {return m_name;}
-    QString getNameWithoutSign() const {return m_name.left(m_name.length() - 1);}
-    QString getSign() const {if (m_name.length() > 0) return m_name.right(1); else return "+";}
+    QString getName() const {return getNameWithoutSign() + getSign();}
+    QString getNameWithoutSign() const {return QString::fromUtf8(m_name);}
+    QString getSign() const {return m_positive ? "+" : "-";}
+    // Non-QString accessors, should be preferred outside of UI code
+    std::string_view getBaseName() const {return m_name;}
+    std::string getStdName() const {return std::string(m_name) + (m_positive ? '+' : '-');}
 
     double getDepth() const {return m_depth;}
 
@@ -76,8 +83,8 @@ public:
     bool isDrawn() const {return m_drawn;}
     bool thisNodeOrReverseComplementIsDrawn() const {return isDrawn() || getReverseComplement()->isDrawn();}
     bool isNotDrawn() const {return !m_drawn;}
-    bool isPositiveNode() const;
-    bool isNegativeNode() const;
+    bool isPositiveNode() const {return m_positive;}
+    bool isNegativeNode() const {return !m_positive;}
 
     bool isNodeConnected(DeBruijnNode * node) const;
     DeBruijnEdge * doesNodeLeadIn(DeBruijnNode * node) const;
@@ -100,10 +107,10 @@ public:
     void removeEdge(DeBruijnEdge * edge);
     void labelNeighbouringNodesAsDrawn(int nodeDistance);
     void setDepth(double newDepth) {m_depth = newDepth;}
-    void setName(QString newName) {m_name = std::move(newName);}
+    void setName(const char *name, bool positive) {m_name = name; m_positive = positive;}
 
 private:
-    QString m_name;
+    const char *m_name;
     Sequence m_sequence;
     DeBruijnNode * m_reverseComplement;
     adt::SmallPODVector<DeBruijnEdge *> m_edges;
@@ -112,7 +119,8 @@ private:
 
     float m_depth;
 
-    unsigned m_length : 30;
+    unsigned m_length;
+    bool m_positive : 1;
     bool m_specialNode : 1;
     bool m_drawn : 1;
 
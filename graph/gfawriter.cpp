@@ -62,7 +62,7 @@ namespace gfa {
         QByteArray gfaSequence = getSequenceForGfa(node);
 
         QByteArray gfaSegmentLine = "S";
-        gfaSegmentLine += "\t" + node->getNameWithoutSign().toLatin1();
+        gfaSegmentLine += "\t" + node->getNameWithoutSign().toUtf8();
         gfaSegmentLine += "\t" + gfaSequence;
         gfaSegmentLine += "\tLN:i:" + QString::number(gfaSequence.length()).toLatin1();
 
@@ -186,7 +186,7 @@ namespace gfa {
             out << getGfaLinkLine(edge, graph) << '\n';
 
         for (auto it = graph.m_deBruijnGraphPaths.begin(); it != graph.m_deBruijnGraphPaths.end(); ++it)
-            out << getGfaPathLine(it.key(), *it, graph) << '\n';
+            out << getGfaPathLine(it.key(), graph.getPath(*it), graph) << '\n';
 
         return true;
     }
@@ -217,7 +217,7 @@ namespace gfa {
             out << getGfaLinkLine(node, graph) << '\n';
 
         for (auto it = graph.m_deBruijnGraphPaths.begin(); it != graph.m_deBruijnGraphPaths.end(); ++it)
-            out << getGfaPathLine(it.key(), *it, graph) << '\n';
+            out << getGfaPathLine(it.key(), graph.getPath(*it), graph) << '\n';
 
         return true;
     }
@@ -54,11 +54,27 @@ void GraphicsItemEdge::paint(QPainter * painter, const QStyleOptionGraphicsItem
 }
 
 QPainterPath GraphicsItemEdge::shape() const {
+    return m_outline;
+}
+
+// The edge is painted with its own pen rather than the item's, so the bounding
+// rectangle is taken from the stroked outline.
+QRectF GraphicsItemEdge::boundingRect() const {
+    return m_outlineBounds;
+}
+
+// Sets the edge path and rebuilds the cached stroked outline used for
+// hit-testing.
+void GraphicsItemEdge::setEdgePath(const QPainterPath &path) {
+    setPath(path);
+
     QPainterPathStroker stroker;
     stroker.setWidth(m_width);
     stroker.setCapStyle(Qt::RoundCap);
     stroker.setJoinStyle(Qt::RoundJoin);
-    return stroker.createStroke(path());
+    m_outline = stroker.createStroke(path);
+    m_outlineBounds = m_outline.boundingRect();
+    ++g_outlineStrokeCount;
 }
 
 static void getControlPointLocations(const DeBruijnEdge *edge,
@@ -175,5 +191,5 @@ void GraphicsItemEdge::remakePath() {
     } else
         makeOrdinaryPath(path, startSegment, endSegment);
 
-    setPath(path);
+    setEdgePath(path);
 }
@@ -21,6 +21,7 @@
 
 #include <QGraphicsPathItem>
 #include <QPainterPath>
+#include <QRectF>
 #include <QPointF>
 
 class DeBruijnEdge;
@@ -33,12 +34,18 @@ public:
 
     void paint(QPainter * painter, const QStyleOptionGraphicsItem *, QWidget *) override;
     QPainterPath shape() const override;
+    QRectF boundingRect() const override;
 
     virtual void remakePath();
     DeBruijnEdge *edge() const { return m_deBruijnEdge; }
 
+protected:
+    void setEdgePath(const QPainterPath &path);
+
 private:
     DeBruijnEdge *m_deBruijnEdge;
+    QPainterPath m_outline;
+    QRectF m_outlineBounds;
     QColor m_edgeColor;
     Qt::PenStyle m_penStyle;
     float m_width;
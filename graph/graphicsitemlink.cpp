@@ -127,5 +127,5 @@ void GraphicsItemLink::remakePath() {
         makeOrdinaryPath(path, startMidSegment, endMidSegment);
     }
 
-    setPath(path);
+    setEdgePath(path);
 }
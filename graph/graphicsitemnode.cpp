@@ -37,7 +37,9 @@
 #include <QMessageBox>
 #include <QFontMetrics>
 #include <QSize>
+#include <QStyleOptionGraphicsItem>
 
+#include <algorithm>
 #include <set>
 
 #include <cmath>
@@ -96,10 +98,24 @@ float GraphicsItemNode::getNodeWidth(double depthRelativeToMeanDrawnDepth, doubl
 
 void GraphicsItemNode::setWidth(double depthRelativeToMeanDrawnDepth, double averageNodeWidth,
                                 double depthPower, double depthEffectOnWidth) {
-    m_width = getNodeWidth(depthRelativeToMeanDrawnDepth,
-                           depthPower, depthEffectOnWidth, averageNodeWidth);
-    if (m_width < 0.0)
-        m_width = 0.0;
+    float width = getNodeWidth(depthRelativeToMeanDrawnDepth,
+                               depthPower, depthEffectOnWidth, averageNodeWidth);
+    if (width < 0.0)
+        width = 0.0;
+    if (width == m_width)
+        return;
+
+    m_width = width;
+
+    // The path is not yet made during construction
+    if (!m_path.isEmpty())
+        updateOutline();
+}
+
+void GraphicsItemNode::updateOutline() {
+    prepareGeometryChange();
+    m_outline = makeOutline();
+    m_outlineBounds = m_outline.boundingRect();
 }
 
 static double distance(QPointF p1, QPointF p2) {
@@ -153,16 +169,57 @@ static bool anyNodeDisplayText() {
            g_settings->displayNodeCsvData;
 }
 
-void GraphicsItemNode::paint(QPainter * painter, const QStyleOptionGraphicsItem *, QWidget *)
-{
-    static AnnotationGroup::AnnotationVector emptyAnnotations{};
+// Node labels are scaled down as the view zooms in so that they do not grow
+// without bound. This returns the scale applied to the label font.
+static double textZoomAdjustment() {
+    double zoom = g_absoluteZoom;
+    if (zoom == 0.0)
+        zoom = 1.0;
+
+    return 1.0 / (1.0 + ((zoom - 1.0) * g_settings->textZoomScaleFactor));
+}
+
+// Level of detail thresholds, in device pixels. Nodes thinner than
+// MinShapedNodeWidth are drawn as a plain polyline stroke, without the stroked
+// outline, arrowheads or annotations. Text is drawn only when the label font is
+// at least MinLegibleTextHeight tall on screen.
+static constexpr double MinShapedNodeWidth = 2.0;
+static constexpr double MinLegibleTextHeight = 4.0;
 
+static bool textIsLegible(double levelOfDetail) {
+    QFontMetrics metrics(g_settings->labelFont);
+    return metrics.height() * textZoomAdjustment() * levelOfDetail >= MinLegibleTextHeight;
+}
+
+void GraphicsItemNode::paint(QPainter * painter, const QStyleOptionGraphicsItem *option, QWidget *)
+{
     //This code lets me see the node's bounding box.
     //I use it for debugging graphics issues.
 //    painter->setBrush(Qt::NoBrush);
 //    painter->setPen(QPen(Qt::black, 1.0));
 //    painter->drawRect(boundingRect());
 
+    double levelOfDetail = option->levelOfDetailFromTransform(painter->worldTransform());
+
+    // When zoomed out far enough that the node is only a pixel or two wide,
+    // none of the outline, arrowhead or annotation details are visible, so just
+    // stroke the node's centre line. Path highlighting is kept as it is what
+    // the user is looking for at this zoom.
+    if (m_width * levelOfDetail < MinShapedNodeWidth) {
+        QPen linePen(QBrush(isSelected() ? g_settings->selectionColour : m_colour), m_width,
+                     Qt::SolidLine, Qt::FlatCap, Qt::RoundJoin);
+        painter->setPen(linePen);
+        painter->drawPath(m_path);
+
+        if (g_memory->pathDialogIsVisible)
+            exactPathHighlightNode(painter);
+        if (g_memory->queryPathDialogIsVisible)
+            queryPathHighlightNode(painter);
+        return;
+    }
+
+    bool drawText = textIsLegible(levelOfDetail);
+
     QPainterPath outlinePath = shape();
 
     //Fill the node's colour
@@ -175,20 +232,36 @@ void GraphicsItemNode::paint(QPainter * painter, const QStyleOptionGraphicsItem
     if (m_hasArrow)
         painter->setClipPath(outlinePath);
 
-    for (const auto &annotationGroup : g_annotationsManager->getGroups()) {
-        auto annotationSettings = g_settings->annotationsSettings[annotationGroup->id];
+    // Only the features overlapping the visible part of the node are drawn
+    const auto &annotationGroups = g_annotationsManager->getGroups();
+    int64_t nodeLength = m_deBruijnNode->getLength();
+    int64_t visibleFrom = 0, visibleTo = -1;
+    double pixelsPerBase = 0;
+    if (!annotationGroups.empty() && nodeLength > 0) {
+        QRectF visibleRect = boundingRect();
+        if (painter->worldTransform().isInvertible())
+            visibleRect &= painter->worldTransform().inverted().mapRect(QRectF(painter->viewport()));
+
+        auto [firstFraction, lastFraction] = getVisibleFractions(visibleRect);
+        if (firstFraction <= lastFraction) {
+            visibleFrom = int64_t(std::floor(firstFraction * nodeLength));
+            visibleTo = std::min(int64_t(std::ceil(lastFraction * nodeLength)), nodeLength - 1);
+        }
+        pixelsPerBase = getNodePathLength() * levelOfDetail / nodeLength;
+    }
 
-        const auto &annotations = annotationGroup->getAnnotations(m_deBruijnNode);
-        const auto &revCompAnnotations = g_settings->doubleMode
-                                         ? emptyAnnotations
-                                         : annotationGroup->getAnnotations(m_deBruijnNode->getReverseComplement());
+    for (const auto &annotationGroup : annotationGroups) {
+        const auto &annotationSettings = g_settings->annotationsSettings[annotationGroup->id];
 
-        for (const auto &annotation : annotations) {
-            annotation->drawFigure(*painter, *this, false, annotationSettings.viewsToShow);
-        }
-        for (const auto &annotation : revCompAnnotations) {
-            annotation->drawFigure(*painter, *this, true, annotationSettings.viewsToShow);
-        }
+        drawAnnotations(*painter, *this, false,
+                        annotationGroup->annotations, m_deBruijnNode,
+                        annotationGroup->views, annotationSettings.viewsToShow,
+                        visibleFrom, visibleTo, pixelsPerBase);
+        if (!g_settings->doubleMode)
+            drawAnnotations(*painter, *this, true,
+                            annotationGroup->annotations, m_deBruijnNode->getReverseComplement(),
+                            annotationGroup->views, annotationSettings.viewsToShow,
+                            nodeLength - 1 - visibleTo, nodeLength - 1 - visibleFrom, pixelsPerBase);
     }
     painter->setClipping(false);
 
@@ -219,7 +292,7 @@ void GraphicsItemNode::paint(QPainter * painter, const QStyleOptionGraphicsItem
         queryPathHighlightNode(painter);
 
     //Draw node labels if there are any to display.
-    if (anyNodeDisplayText())
+    if (drawText && anyNodeDisplayText())
     {
         QStringList nodeText = getNodeText();
         QPainterPath textPath;
@@ -246,21 +319,20 @@ void GraphicsItemNode::paint(QPainter * painter, const QStyleOptionGraphicsItem
     }
 
     //Draw BLAST hit labels, if appropriate.
-    for (const auto &annotationGroup : g_annotationsManager->getGroups()) {
+    if (!drawText)
+        return;
+
+    for (const auto &annotationGroup : annotationGroups) {
         if (!g_settings->annotationsSettings[annotationGroup->id].showText)
             continue;
 
-        const auto &annotations = annotationGroup->getAnnotations(m_deBruijnNode);
-        const auto &revCompAnnotations = g_settings->doubleMode
-                                         ? emptyAnnotations
-                                         : annotationGroup->getAnnotations(m_deBruijnNode->getReverseComplement());
-
-        for (const auto &annotation : annotations) {
-            annotation->drawDescription(*painter, *this, false);
-        }
-        for (const auto &annotation : revCompAnnotations) {
-            annotation->drawDescription(*painter, *this, true);
-        }
+        drawAnnotationDescriptions(*painter, *this, false,
+                                   annotationGroup->annotations, m_deBruijnNode,
+                                   visibleFrom, visibleTo, pixelsPerBase);
+        if (!g_settings->doubleMode)
+            drawAnnotationDescriptions(*painter, *this, true,
+                                       annotationGroup->annotations, m_deBruijnNode->getReverseComplement(),
+                                       nodeLength - 1 - visibleTo, nodeLength - 1 - visibleFrom, pixelsPerBase);
     }
 }
 
@@ -271,11 +343,7 @@ void GraphicsItemNode::drawTextPathAtLocation(QPainter * painter, const QPainter
     double textHeight = textBoundingRect.height();
     QPointF offset(0.0, textHeight / 2.0);
 
-    double zoom = g_absoluteZoom;
-    if (zoom == 0.0)
-        zoom = 1.0;
-
-    double zoomAdjustment = 1.0 / (1.0 + ((zoom - 1.0) * g_settings->textZoomScaleFactor));
+    double zoomAdjustment = textZoomAdjustment();
     double inverseZoomAdjustment = 1.0 / zoomAdjustment;
 
     painter->translate(centre);
@@ -301,6 +369,14 @@ void GraphicsItemNode::drawTextPathAtLocation(QPainter * painter, const QPainter
 }
 
 QPainterPath GraphicsItemNode::shape() const
+{
+    return m_outline;
+}
+
+// Builds the node's outline (the stroked path plus the arrowhead). This is
+// relatively expensive, so the result is cached in m_outline and only rebuilt
+// when the node's path or width changes.
+QPainterPath GraphicsItemNode::makeOutline() const
 {
     //If there is only one segment, and it is shorter than half its
     //width, then the arrow head will not be made with 45 degree
@@ -326,6 +402,7 @@ QPainterPath GraphicsItemNode::shape() const
     stroker.setCapStyle(Qt::FlatCap);
     stroker.setJoinStyle(Qt::RoundJoin);
     QPainterPath mainNodePath = stroker.createStroke(m_path);
+    ++g_outlineStrokeCount;
 
     if (!m_hasArrow)
         return mainNodePath;
@@ -410,10 +487,7 @@ void GraphicsItemNode::mouseMoveEvent(QGraphicsSceneMouseEvent * event)
         nodesToMove.push_back(this);
 
     for (auto &node : nodesToMove)
-    {
         node->shiftPoints(difference);
-        node->remakePath();
-    }
     graphicsScene->possiblyExpandSceneRectangle(&nodesToMove);
 
     fixEdgePaths(&nodesToMove);
@@ -455,8 +529,6 @@ void GraphicsItemNode::fixEdgePaths(std::vector<GraphicsItemNode *> * nodes) con
 
 void GraphicsItemNode::shiftPoints(QPointF difference)
 {
-    prepareGeometryChange();
-
     if (g_settings->nodeDragging == NO_DRAGGING)
         return;
 
@@ -478,6 +550,8 @@ void GraphicsItemNode::shiftPoints(QPointF difference)
             m_linePoints[i] += difference * dragStrength;
         }
     }
+
+    remakePath();
 }
 
 void GraphicsItemNode::remakePath()
@@ -489,6 +563,7 @@ void GraphicsItemNode::remakePath()
         path.lineTo(m_linePoints[i]);
 
     m_path = path;
+    updateOutline();
 }
 
 static QPointF findIntermediatePoint(QPointF p1, QPointF p2, double p1Value, double p2Value, double targetValue) {
@@ -558,6 +633,42 @@ double GraphicsItemNode::getNodePathLength()
     return totalLength;
 }
 
+// Returns the range of fractions along the node's path that is inside the
+// given rectangle (in item coordinates). The test is done on the bounding boxes
+// of path segments, so the range might be slightly larger. The range is empty
+// (first > second) if no part of the path is inside.
+std::pair<double, double> GraphicsItemNode::getVisibleFractions(const QRectF &rect) const
+{
+    QRectF area = rect.adjusted(-m_width, -m_width, m_width, m_width);
+
+    double totalLength = 0.0;
+    for (size_t i = 0; i < m_linePoints.size() - 1; ++i)
+        totalLength += QLineF(m_linePoints[i], m_linePoints[i + 1]).length();
+
+    if (totalLength == 0.0)
+        return { 0.0, 1.0 };
+
+    double firstFraction = 1.0, lastFraction = 0.0;
+    double lengthSoFar = 0.0;
+    for (size_t i = 0; i < m_linePoints.size() - 1; ++i)
+    {
+        QPointF point1 = m_linePoints[i];
+        QPointF point2 = m_linePoints[i + 1];
+        double segmentLength = QLineF(point1, point2).length();
+
+        if (std::max(point1.x(), point2.x()) >= area.left() && std::min(point1.x(), point2.x()) <= area.right() &&
+            std::max(point1.y(), point2.y()) >= area.top() && std::min(point1.y(), point2.y()) <= area.bottom())
+        {
+            firstFraction = std::min(firstFraction, lengthSoFar / totalLength);
+            lastFraction = std::max(lastFraction, (lengthSoFar + segmentLength) / totalLength);
+        }
+
+        lengthSoFar += segmentLength;
+    }
+
+    return { firstFraction, lastFraction };
+}
+
 //This function will find the point that is a certain fraction of the way along the node's path.
 QPointF GraphicsItemNode::findLocationOnPath(double fraction)
 {
@@ -716,7 +827,7 @@ QSize GraphicsItemNode::getNodeTextSize(const QString& text)
 QRectF GraphicsItemNode::boundingRect() const
 {
     double extraSize = g_settings->selectionThickness / 2.0;
-    QRectF bound = shape().boundingRect();
+    QRectF bound = m_outlineBounds;
 
     bound.setTop(bound.top() - extraSize);
     bound.setBottom(bound.bottom() + extraSize);
@@ -743,8 +854,6 @@ void GraphicsItemNode::shiftPointsRight()
 
 void GraphicsItemNode::shiftPointSideways(bool left)
 {
-    prepareGeometryChange();
-
     //The collection of line points should be at least
     //two large.  But just to be safe, quit now if it
     //is not.
@@ -904,6 +1013,7 @@ QPainterPath GraphicsItemNode::buildPartialHighlightPath(double startFraction,
     stroker.setCapStyle(Qt::FlatCap);
     stroker.setJoinStyle(Qt::RoundJoin);
     QPainterPath highlightPath = stroker.createStroke(partialPath);
+    ++g_outlineStrokeCount;
 
     if (m_hasArrow)
         highlightPath = highlightPath.intersected(shape());
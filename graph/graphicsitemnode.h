@@ -25,10 +25,12 @@
 #include <QFont>
 #include <QString>
 #include <QPainterPath>
+#include <QRectF>
 #include <QStringList>
 #include <QGraphicsItem>
 #include <QGraphicsSceneMouseEvent>
 
+#include <utility>
 #include <vector>
 
 class DeBruijnNode;
@@ -94,6 +96,7 @@ public:
     QPainterPath makePartialPath(double startFraction, double endFraction);
     double getNodePathLength();
     QPointF findLocationOnPath(double fraction);
+    std::pair<double, double> getVisibleFractions(const QRectF &rect) const;
     QRectF boundingRect() const override;
     void shiftPointsLeft();
     void shiftPointsRight();
@@ -106,4 +109,9 @@ private:
     void pathHighlightNode2(QPainter * painter, DeBruijnNode * node, bool reverse, Path * path);
     QPainterPath buildPartialHighlightPath(double startFraction, double endFraction, bool reverse);
     void shiftPointSideways(bool left);
+    QPainterPath makeOutline() const;
+    void updateOutline();
+
+    QPainterPath m_outline;
+    QRectF m_outlineBounds;
 };
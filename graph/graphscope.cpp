@@ -62,7 +62,8 @@ namespace graph {
                     return {};
                 }
 
-                return pathIt->nodes();
+                auto nodes = graph.m_pathStore.nodes(*pathIt);
+                return { nodes.begin(), nodes.end() };
             }
             case AROUND_WALKS: {
                 auto pathIt = graph.m_deBruijnGraphWalks.find(graphScope.walk().toStdString());
@@ -72,7 +73,8 @@ namespace graph {
                     return {};
                 }
 
-                return pathIt->walk.nodes();
+                auto nodes = graph.m_walkStore.nodes(pathIt->pathId);
+                return { nodes.begin(), nodes.end() };
             }
             case AROUND_BLAST_HITS: {
                 std::vector<DeBruijnNode *> startingNodes;
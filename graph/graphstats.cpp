@@ -0,0 +1,282 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "graphstats.h"
+
+#include "assemblygraph.h"
+#include "debruijnedge.h"
+#include "debruijnnode.h"
+
+#include "parallel_hashmap/phmap.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace graph {
+
+static constexpr size_t NodesPerChunk = 65536;
+
+namespace {
+struct ChunkStats {
+    size_t begin = 0, end = 0;
+    long long totalLength = 0;
+    long long totalLengthNoOverlaps = 0;
+    long long totalLengthOrphanedNodes = 0;
+    unsigned deadEnds = 0;
+    long long estimatedSequenceLength = 0;
+};
+
+class UnionFind {
+  public:
+    explicit UnionFind(size_t size)
+            : m_parent(size) {
+        std::iota(m_parent.begin(), m_parent.end(), 0);
+    }
+
+    uint32_t find(uint32_t x) {
+        while (m_parent[x] != x) {
+            m_parent[x] = m_parent[m_parent[x]];
+            x = m_parent[x];
+        }
+        return x;
+    }
+
+    void unite(uint32_t x, uint32_t y) {
+        x = find(x); y = find(y);
+        if (x != y)
+            m_parent[std::max(x, y)] = std::min(x, y);
+    }
+
+  private:
+    std::vector<uint32_t> m_parent;
+};
+}
+
+// Returns the element at which the cumulative weight of the range, taken in
+// the order given by comp, first reaches the target. Expected linear time.
+template<class It, class Weight, class Compare>
+static It selectByWeight(It first, It last, long long target,
+                         Weight weight, Compare comp) {
+    while (last - first > 1) {
+        It mid = first + (last - first) / 2;
+        std::nth_element(first, mid, last, comp);
+
+        long long before = 0;
+        for (It it = first; it != mid; ++it)
+            before += weight(*it);
+
+        if (before >= target) {
+            last = mid;
+        } else if (before + weight(*mid) >= target) {
+            return mid;
+        } else {
+            target -= before + weight(*mid);
+            first = mid + 1;
+        }
+    }
+
+    return first;
+}
+
+// Same as interpolating between the neighbouring elements of a sorted vector,
+// but only partially orders the values. Indices must be given in increasing
+// order.
+static std::vector<double> getValuesAtFractionalIndices(std::vector<int> &values,
+                                                        const std::vector<double> &indices) {
+    std::vector<double> res;
+    auto first = values.begin();
+    for (double index : indices) {
+        size_t wholePart = std::floor(index);
+        double fractionalPart = index - wholePart;
+
+        auto nth = values.begin() + wholePart;
+        std::nth_element(first, nth, values.end());
+        double piece1 = *nth, piece2 = piece1;
+        if (wholePart + 1 < values.size())
+            piece2 = *std::min_element(nth + 1, values.end());
+        res.push_back(piece1 * (1.0 - fractionalPart) + piece2 * fractionalPart);
+
+        first = nth;
+    }
+
+    return res;
+}
+
+GraphStats computeGraphStats(const AssemblyGraph &graph) {
+    GraphStats stats;
+
+    std::vector<const DeBruijnNode *> nodes;
+    nodes.reserve(graph.m_deBruijnGraphNodes.size() / 2);
+    for (const DeBruijnNode *node : graph.m_deBruijnGraphNodes) {
+        if (node->isPositiveNode())
+            nodes.push_back(node);
+    }
+
+    if (nodes.empty())
+        return stats;
+
+    phmap::flat_hash_map<const DeBruijnNode *, uint32_t> nodeIndices;
+    nodeIndices.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+        nodeIndices.emplace(nodes[i], i);
+
+    // Per-node pass: lengths and depths go into flat arrays, everything else
+    // is summed up per chunk
+    std::vector<int> lengths(nodes.size()), trimmedLengths(nodes.size());
+    std::vector<double> depths(nodes.size());
+    std::vector<ChunkStats> chunks;
+    for (size_t begin = 0; begin < nodes.size(); begin += NodesPerChunk) {
+        auto &chunk = chunks.emplace_back();
+        chunk.begin = begin;
+        chunk.end = std::min(begin + NodesPerChunk, nodes.size());
+    }
+
+    QtConcurrent::blockingMap(chunks, [&](ChunkStats &chunk) {
+        for (size_t i = chunk.begin; i < chunk.end; ++i) {
+            const DeBruijnNode *node = nodes[i];
+            int length = node->getLength();
+            lengths[i] = length;
+            depths[i] = node->getDepth();
+
+            // Edge-derived values come from the graph metrics cache
+            NodeMetrics metrics = graph.m_nodeMetrics.get(node);
+            bool hasEntering = metrics.inDegree > 0, hasLeaving = metrics.outDegree > 0;
+            trimmedLengths[i] = metrics.trimmedLength;
+
+            chunk.totalLength += length;
+            chunk.totalLengthNoOverlaps += length - metrics.maxOverlap;
+            if (!hasEntering && !hasLeaving) {
+                chunk.deadEnds += 2;
+                chunk.totalLengthOrphanedNodes += length;
+            } else if (!hasEntering || !hasLeaving) {
+                chunk.deadEnds += 1;
+            }
+        }
+    });
+
+    stats.nodeCount = nodes.size();
+    for (const auto &chunk : chunks) {
+        stats.totalLength += chunk.totalLength;
+        stats.totalLengthNoOverlaps += chunk.totalLengthNoOverlaps;
+        stats.totalLengthOrphanedNodes += chunk.totalLengthOrphanedNodes;
+        stats.deadEnds += chunk.deadEnds;
+    }
+    stats.percentageDeadEnds = 100.0 * double(stats.deadEnds) / (2 * stats.nodeCount);
+
+    // Edge pass: overlap range and connected components
+    UnionFind components(nodes.size());
+    int smallestOverlap = std::numeric_limits<int>::max();
+    for (const DeBruijnEdge *edge : graph.m_deBruijnGraphEdges) {
+        int overlap = edge->getOverlap();
+        smallestOverlap = std::min(smallestOverlap, overlap);
+        stats.largestOverlap = std::max(stats.largestOverlap, overlap);
+        if (edge->isPositiveEdge())
+            ++stats.edgeCount;
+
+        const DeBruijnNode *start = edge->getStartingNode(), *end = edge->getEndingNode();
+        if (!start->isPositiveNode())
+            start = start->getReverseComplement();
+        if (!end->isPositiveNode())
+            end = end->getReverseComplement();
+        components.unite(nodeIndices.at(start), nodeIndices.at(end));
+    }
+    stats.smallestOverlap =
+            smallestOverlap == std::numeric_limits<int>::max() ? 0 : smallestOverlap;
+
+    std::vector<long long> componentLengths(nodes.size());
+    std::vector<unsigned> componentNodeCounts(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        uint32_t root = components.find(i);
+        componentLengths[root] += lengths[i];
+        componentNodeCounts[root] += 1;
+    }
+
+    std::map<unsigned, unsigned> componentSizes;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (componentNodeCounts[i] == 0)
+            continue;
+        ++stats.componentCount;
+        ++componentSizes[componentNodeCounts[i]];
+        stats.largestComponentLength = std::max(stats.largestComponentLength, componentLengths[i]);
+    }
+    stats.componentSizes.assign(componentSizes.begin(), componentSizes.end());
+
+    // Node length order statistics
+    auto [shortest, longest] = std::minmax_element(lengths.begin(), lengths.end());
+    stats.shortestNode = *shortest;
+    stats.longestNode = *longest;
+
+    if (stats.totalLength > 0) {
+        std::vector<int> nodeLengths = lengths;
+        double lastIndex = nodeLengths.size() - 1;
+        auto quartiles = getValuesAtFractionalIndices(nodeLengths,
+                                                      { lastIndex / 4.0, lastIndex / 2.0, lastIndex * 3.0 / 4.0 });
+        stats.firstQuartile = std::round(quartiles[0]);
+        stats.median = std::round(quartiles[1]);
+        stats.thirdQuartile = std::round(quartiles[2]);
+
+        // N50: the length at which the longest nodes add up to at least half
+        // of the total length
+        stats.n50 = *selectByWeight(nodeLengths.begin(), nodeLengths.end(),
+                                    (stats.totalLength + 1) / 2,
+                                    [](int length) { return length; },
+                                    std::greater<>());
+
+        // Median depth by base: the depth of the node covering the middle base
+        // when the nodes are ordered by depth
+        std::vector<std::pair<double, int>> depthsAndLengths(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i)
+            depthsAndLengths[i] = { depths[i], lengths[i] };
+
+        auto depthAtBase = [&](long long index) {
+            return selectByWeight(depthsAndLengths.begin(), depthsAndLengths.end(),
+                                  index + 1,
+                                  [](const auto &entry) { return entry.second; },
+                                  [](const auto &a, const auto &b) { return a.first < b.first; })->first;
+        };
+
+        if (nodes.size() == 1)
+            stats.medianDepthByBase = depths.front();
+        else if (stats.totalLength % 2 == 0)
+            stats.medianDepthByBase = (depthAtBase(stats.totalLength / 2 - 1) +
+                                       depthAtBase(stats.totalLength / 2)) / 2.0;
+        else
+            stats.medianDepthByBase = depthAtBase((stats.totalLength - 1) / 2);
+    }
+
+    if (stats.medianDepthByBase != 0.0) {
+        double medianDepth = stats.medianDepthByBase;
+        QtConcurrent::blockingMap(chunks, [&](ChunkStats &chunk) {
+            for (size_t i = chunk.begin; i < chunk.end; ++i)
+                chunk.estimatedSequenceLength += (long long)trimmedLengths[i] * std::lround(depths[i] / medianDepth);
+        });
+
+        for (const auto &chunk : chunks)
+            stats.estimatedSequenceLength += chunk.estimatedSequenceLength;
+    }
+
+    return stats;
+}
+
+}
@@ -16,16 +16,24 @@
 // along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "io.h"
+#include "annotationstore.h"
 #include "assemblygraph.h"
 
 #include "io/cigar.h"
 #include "io/gfa.h"
+#include "io/bedloader.h"
 #include "io/gaf.h"
+#include "io/linereader.h"
 
 #include <csv/csv.hpp>
 
 #include <QFile>
 #include <QTextStream>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
 #include <stdexcept>
 
 namespace io {
@@ -42,7 +50,7 @@ namespace {
             throw std::logic_error("Cannot find node: " + toNodeName);
 
         DeBruijnEdge *edgePtr = nullptr, *rcEdgePtr = nullptr;
-        edgePtr = new DeBruijnEdge(fromNode, toNode);
+        edgePtr = graph.createEdge(fromNode, toNode);
 
         bool isOwnPair = fromNode == toNode->getReverseComplement() &&
                          toNode == fromNode->getReverseComplement();
@@ -55,7 +63,7 @@ namespace {
         } else {
             auto *rcFromNodePtr = fromNode->getReverseComplement();
             auto *rcToNodePtr = toNode->getReverseComplement();
-            rcEdgePtr = new DeBruijnEdge(rcToNodePtr, rcFromNodePtr);
+            rcEdgePtr = graph.createEdge(rcToNodePtr, rcFromNodePtr);
             rcFromNodePtr->addEdge(rcEdgePtr);
             rcToNodePtr->addEdge(rcEdgePtr);
             edgePtr->setReverseComplement(rcEdgePtr);
@@ -83,6 +91,44 @@ namespace {
 
         return { edgePtr, rcEdgePtr };
     }
+
+    // Resolves BED sequence names to graph nodes. Features are usually sorted
+    // by sequence, so the last name is checked first and every distinct name
+    // is looked up in the graph only once.
+    class NodeResolver {
+      public:
+        explicit NodeResolver(const AssemblyGraph &graph)
+                : graph_(graph) {}
+
+        DeBruijnNode *resolve(std::string_view name) {
+            if (hasLast_ && name == lastName_)
+                return lastNode_;
+
+            DeBruijnNode *node = nullptr;
+            auto it = cache_.find(name);
+            if (it != cache_.end()) {
+                node = it->second;
+            } else {
+                QString nodeName = graph_.getNodeNameFromString(QString::fromUtf8(name.data(), qsizetype(name.size())));
+                auto nodeIt = graph_.m_deBruijnGraphNodes.find(nodeName.toStdString());
+                if (nodeIt != graph_.m_deBruijnGraphNodes.end())
+                    node = *nodeIt;
+                cache_.emplace(name, node);
+            }
+
+            lastName_.assign(name);
+            lastNode_ = node;
+            hasLast_ = true;
+            return node;
+        }
+
+      private:
+        const AssemblyGraph &graph_;
+        phmap::flat_hash_map<std::string, DeBruijnNode*> cache_;
+        std::string lastName_;
+        DeBruijnNode *lastNode_ = nullptr;
+        bool hasLast_ = false;
+    };
 }
 
     bool loadGFAPaths(AssemblyGraph &graph,
@@ -107,11 +153,12 @@ namespace {
 
                 for (const auto &node: path->segments)
                     pathNodes.push_back(graph.m_deBruijnGraphNodes.at(node));
-                graph.m_deBruijnGraphPaths.emplace(path->name,
-                                                   Path::makeFromOrderedNodes(pathNodes, false));
+                graph.addPath(path->name, Path::makeFromOrderedNodes(pathNodes, false));
             }
         }
 
+        graph.buildPathIndices();
+
         return true;
     }
 
@@ -196,48 +243,93 @@ namespace {
 
 
     bool loadGAFPaths(AssemblyGraph &graph,
-                      QString fileName) {
-        QFile inputFile(fileName);
-        if (!inputFile.open(QIODevice::ReadOnly))
+                      QString fileName,
+                      const GAFFilter &filter,
+                      size_t *skippedRecords) {
+        auto reader = LineReader::open(fileName);
+        if (!reader)
             return false;
 
-        QTextStream in(&inputFile);
-        while (!in.atEnd()) {
-            QByteArray line = in.readLine().toLatin1();
-            if (line.length() == 0)
-                continue;
+        std::atomic<size_t> skipped = 0;
+        std::vector<std::optional<std::pair<std::string, Path>>> alignments;
+        auto parseRange = [&](const LineChunk &chunk, std::pair<size_t, size_t> range) {
+            std::string nodeName;
+            std::vector<DeBruijnNode *> pathNodes;
+            for (size_t i = range.first; i < range.second; ++i) {
+                std::string_view line = chunk.lines[i];
+                if (line.empty())
+                    continue;
+
+                auto record = gaf::parseRecord(line.data(), line.length());
+                if (!record)
+                    continue;
+
+                if (record->mapq < filter.minMapQ ||
+                    record->alen < filter.minAlignmentLength) {
+                    skipped += 1;
+                    continue;
+                }
 
-            auto path = gaf::parseRecord(line.data(), line.length());
-            if (!path)
-                continue;
+                // Segments are always oriented here, the grammar ensures this
+                pathNodes.clear();
+                bool resolved = true;
+                for (std::string_view segment : record->segments) {
+                    nodeName.assign(segment.substr(1));
+                    nodeName.push_back(segment.front() == '>' ? '+' : '-');
+                    auto it = graph.m_deBruijnGraphNodes.find(nodeName);
+                    if (it == graph.m_deBruijnGraphNodes.end()) {
+                        resolved = false;
+                        break;
+                    }
+                    pathNodes.push_back(*it);
+                }
 
-            std::vector<DeBruijnNode *> pathNodes;
-            pathNodes.reserve(path->segments.size());
-
-            // FIXME: handle orientation
-            // FIXME: handle start / end positions
-            for (const auto &node: path->segments) {
-                char orientation = node.front();
-                std::string nodeName;
-                nodeName.reserve(node.size());
-                nodeName = node.substr(1);
-                if (orientation == '>')
-                    nodeName.push_back('+');
-                else if (orientation == '<')
-                    nodeName.push_back('-');
-                else
-                    throw std::runtime_error(std::string("invalid path string: ").append(node));
-
-                pathNodes.push_back(graph.m_deBruijnGraphNodes.at(nodeName));
+                // Alignments to nodes not in the graph are skipped rather than
+                // failing the whole file
+                if (!resolved) {
+                    skipped += 1;
+                    continue;
+                }
+
+                Path p(Path::makeFromOrderedNodes(pathNodes, false));
+                // Start / end positions on path are zero-based, graph location is 1-based. So we'd just trim
+                // the corresponding amounts
+                p.trim(record->pstart, record->plen - record->pend - 1);
+                alignments[i].emplace(record->name, std::move(p));
             }
+        };
 
-            Path p(Path::makeFromOrderedNodes(pathNodes, false));
-            // Start / end positions on path are zero-based, graph location is 1-based. So we'd just trim
-            // the corresponding amounts
-            p.trim(path->pstart, path->plen - path->pend - 1);
-            graph.m_deBruijnGraphPaths.emplace(path->name, std::move(p));
+        // Parse lines in batches to amortize the scheduling overhead, node
+        // trie is only read here, so lookups could be done concurrently
+        constexpr size_t BatchSize = 1024;
+        LineChunk chunk;
+        std::vector<std::pair<size_t, size_t>> batches;
+        while (reader->read(chunk)) {
+            const auto &lines = chunk.lines;
+            alignments.clear();
+            alignments.resize(lines.size());
+
+            batches.clear();
+            for (size_t i = 0; i < lines.size(); i += BatchSize)
+                batches.emplace_back(i, std::min(i + BatchSize, lines.size()));
+
+            QtConcurrent::blockingMap(batches,
+                                      [&](std::pair<size_t, size_t> range) { parseRange(chunk, range); });
+
+            for (auto &alignment : alignments) {
+                if (alignment)
+                    graph.addPath(alignment->first, alignment->second);
+            }
         }
 
+        if (reader->error())
+            return false;
+
+        if (skippedRecords)
+            *skippedRecords = skipped;
+
+        graph.buildPathIndices();
+
         return true;
     }
 
@@ -287,7 +379,7 @@ namespace {
                 if (!ok)
                     ePos = pathNodes.back()->getLength() - 1;
                 p.trim(sPos, pathNodes.back()->getLength() - ePos - 1);
-                graph.m_deBruijnGraphPaths.emplace(name, std::move(p));
+                graph.addPath(name, p);
             };
             if (pathParts.size() == 1) {
                 // Keep the name as-is
@@ -302,6 +394,8 @@ namespace {
             }
         }
 
+        graph.buildPathIndices();
+
         return true;
     }
 
@@ -347,8 +441,7 @@ namespace {
                         for (const auto &nodeName: path.split(","))
                             pathNodes.push_back(graph.m_deBruijnGraphNodes.at(nodeName.toStdString()));
 
-                        graph.m_deBruijnGraphPaths.emplace(name,
-                                                           Path::makeFromOrderedNodes(pathNodes, false));
+                        graph.addPath(name, Path::makeFromOrderedNodes(pathNodes, false));
                     };
 
                     // Parse but do not add reverse-complementary paths
@@ -366,7 +459,83 @@ namespace {
             }
         }
 
+        graph.buildPathIndices();
+
         return true;
     }
 
+    bool loadBEDAnnotations(const AssemblyGraph &graph,
+                            QString fileName,
+                            AnnotationStore &annotations,
+                            bool drawnNodesOnly) {
+        NodeResolver resolver(graph);
+        bed::Line bedLine;
+
+        // Reads the features from the reader. If chrom is given, reading stops
+        // at the first feature on a different sequence.
+        auto loadFeatures = [&](LineReader &reader, std::optional<std::string_view> chrom) {
+            LineChunk chunk;
+            while (reader.read(chunk)) {
+                for (std::string_view line : chunk.lines) {
+                    if (!bed::parseLine(line, bedLine))
+                        continue;
+                    if (chrom && bedLine.chrom != *chrom)
+                        return !reader.error();
+
+                    DeBruijnNode *node = resolver.resolve(bedLine.chrom);
+                    if (!node || (drawnNodesOnly && !node->thisNodeOrReverseComplementIsDrawn()))
+                        continue;
+
+                    if (bedLine.strand == bed::Strand::REVERSE_COMPLEMENT)
+                        node = node->getReverseComplement();
+
+                    const auto &rgb = bedLine.itemRgb;
+                    auto id = annotations.add(node, bedLine.chromStart, bedLine.chromEnd,
+                                              qRgb(rgb.r, rgb.g, rgb.b), bedLine.name);
+                    // Optional columns are only allocated once some feature needs them
+                    if (bedLine.thickStart != bedLine.chromStart || bedLine.thickEnd != bedLine.chromEnd)
+                        annotations.setThick(id, bedLine.thickStart, bedLine.thickEnd);
+                    if (!bedLine.blocks.empty())
+                        annotations.setBlocks(id, bedLine.blocks);
+                }
+            }
+
+            return !reader.error();
+        };
+
+        // Use the index only if a small part of the sequences is needed,
+        // otherwise streaming through the whole file is faster
+        std::optional<bed::TabixIndex> index;
+        if (drawnNodesOnly)
+            index = bed::TabixIndex::load(fileName + ".tbi");
+
+        std::vector<std::pair<uint64_t, std::string_view>> regions;
+        if (index) {
+            for (const auto &[chrom, offset] : index->offsets()) {
+                DeBruijnNode *node = resolver.resolve(chrom);
+                if (node && node->thisNodeOrReverseComplementIsDrawn())
+                    regions.emplace_back(offset, chrom);
+            }
+        }
+
+        bool success = true;
+        if (index && regions.size() * 2 < index->offsets().size()) {
+            // Read the file sequentially
+            std::sort(regions.begin(), regions.end());
+            for (const auto &[offset, chrom] : regions) {
+                auto reader = LineReader::openBgzf(fileName, offset);
+                if (!reader || !loadFeatures(*reader, chrom)) {
+                    success = false;
+                    break;
+                }
+            }
+        } else {
+            auto reader = LineReader::open(fileName);
+            success = reader && loadFeatures(*reader, std::nullopt);
+        }
+
+        annotations.buildIndex();
+
+        return success;
+    }
 }
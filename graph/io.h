@@ -26,6 +26,7 @@
 #include <vector>
 
 class AssemblyGraph;
+class AnnotationStore;
 class DeBruijnEdge;
 
 namespace io {
@@ -41,6 +42,15 @@ namespace io {
         [[nodiscard]] bool hasComplexOverlaps() const { return hasComplexOverlaps_; }
 
         void treatJumpsAsLinks(bool val = true) { jumpsAsLinks_ = val; }
+        // Read the input twice: segments first, everything else afterwards
+        void useTwoPass(bool val = true) { twoPass_ = val; }
+        // Number of threads used to parse the input, 0 means all available cores
+        void setThreads(unsigned threads) { threads_ = threads; }
+
+        // Input processing throughput of the last build (in MB/s), 0 if unknown
+        [[nodiscard]] double throughput() const {
+            return elapsed_ > 0 ? double(bytesProcessed_) / (1024.0 * 1024.0) / elapsed_ : 0;
+        }
 
     protected:
         explicit AssemblyGraphBuilder(QString fileName)
@@ -51,6 +61,10 @@ namespace io {
         bool hasCustomColours_ = false;
         bool hasComplexOverlaps_ = false;
         bool jumpsAsLinks_ = false;
+        bool twoPass_ = false;
+        unsigned threads_ = 0;
+        size_t bytesProcessed_ = 0;
+        double elapsed_ = 0;
     };
 
     bool handleStandardGFAEdgeTags(const DeBruijnEdge *edgePtr,
@@ -63,7 +77,27 @@ namespace io {
                       std::vector<DeBruijnEdge*> *newEdges = nullptr);
     bool loadLinks(AssemblyGraph &graph, QString fileName,
                    std::vector<DeBruijnEdge*> *newEdges = nullptr);
-    bool loadGAFPaths(AssemblyGraph &graph, QString fileName);
+    // Alignments that do not pass the filter are not loaded
+    struct GAFFilter {
+        unsigned minMapQ = 0;
+        size_t minAlignmentLength = 0;
+    };
+
+    // Plain and gzip-compressed files are supported. Records that fail the
+    // filter or refer to nodes missing from the graph are skipped and counted
+    // in skippedRecords.
+    bool loadGAFPaths(AssemblyGraph &graph, QString fileName,
+                      const GAFFilter &filter = {},
+                      size_t *skippedRecords = nullptr);
     bool loadSPAlignerPaths(AssemblyGraph &graph, QString fileName);
     bool loadSPAdesPaths(AssemblyGraph &graph, QString fileName);
+
+    // Loads BED features as annotations; plain and gzip-compressed files are
+    // supported. Features on sequences that are not graph nodes are skipped.
+    // If drawnNodesOnly is set, only features on the drawn nodes are loaded
+    // and a tabix index (<fileName>.tbi) of a bgzip-compressed file, if
+    // present, is used to read only the relevant parts of the file.
+    bool loadBEDAnnotations(const AssemblyGraph &graph, QString fileName,
+                            AnnotationStore &annotations,
+                            bool drawnNodesOnly = false);
 }
@@ -0,0 +1,71 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "parallel_hashmap/phmap.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace graph {
+
+// Stores each distinct name once as NUL-terminated UTF-8 string (the same
+// encoding as the node map keys) in large contiguous blocks. Returned pointers stay valid until the table is cleared.
+class NameTable {
+  public:
+    static constexpr size_t BlockSize = 1024 * 1024;
+
+    const char *intern(std::string_view name) {
+        auto it = names_.find(name);
+        if (it != names_.end())
+            return it->data();
+
+        size_t size = name.size() + 1;
+        if (blocks_.empty() || used_ + size > blockCapacity_) {
+            blockCapacity_ = std::max(BlockSize, size);
+            blocks_.emplace_back(new char[blockCapacity_]);
+            used_ = 0;
+        }
+
+        char *ptr = blocks_.back().get() + used_;
+        std::memcpy(ptr, name.data(), name.size());
+        ptr[name.size()] = '\0';
+        used_ += size;
+
+        names_.emplace(ptr, name.size());
+        return ptr;
+    }
+
+    void clear() {
+        names_.clear();
+        blocks_.clear();
+        used_ = blockCapacity_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return names_.size(); }
+
+  private:
+    phmap::flat_hash_set<std::string_view> names_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t used_ = 0, blockCapacity_ = 0;
+};
+
+}
@@ -72,15 +72,17 @@ std::unique_ptr<INodeColorer> INodeColorer::create(NodeColorScheme scheme) {
 
 QColor DepthNodeColorer::get(const GraphicsItemNode *node) {
     const DeBruijnNode *deBruijnNode = node->m_deBruijnNode;
-    double depth = deBruijnNode->getDepth();
 
-    double lowValue = g_settings->lowDepthValue, highValue = g_settings->highDepthValue;
+    // The automatic range is the graph interquartile range, so the position
+    // within it is cached together with other node metrics
+    float fraction;
     if (g_settings->autoDepthValue) {
-        lowValue = m_graph->m_firstQuartileDepth;
-        highValue = m_graph->m_thirdQuartileDepth;
+        fraction = m_graph->m_nodeMetrics.get(deBruijnNode).depthFraction;
+    } else {
+        double lowValue = g_settings->lowDepthValue, highValue = g_settings->highDepthValue;
+        fraction = (deBruijnNode->getDepth() - lowValue) / (highValue - lowValue);
     }
 
-    float fraction = (depth - lowValue) / (highValue - lowValue);
     return tinycolormap::GetColor(fraction, colorMap(g_settings->colorMap)).ConvertToQColor();
 }
 
@@ -327,7 +329,7 @@ QColor ContiguityNodeColorer::get(const GraphicsItemNode *node) {
 
 QColor GCNodeColorer::get(const GraphicsItemNode *node) {
     const DeBruijnNode *deBruijnNode = node->m_deBruijnNode;
-    float lowValue = 0.2, highValue = 0.8, value = deBruijnNode->getGC();
+    float lowValue = 0.2, highValue = 0.8, value = m_graph->m_nodeMetrics.get(deBruijnNode).gc;
     float fraction = (value - lowValue) / (highValue - lowValue);
     return tinycolormap::GetColor(fraction, colorMap(g_settings->colorMap)).ConvertToQColor();
 }
@@ -335,16 +337,29 @@ QColor GCNodeColorer::get(const GraphicsItemNode *node) {
 QColor TagValueNodeColorer::get(const GraphicsItemNode *node) {
     const DeBruijnNode *deBruijnNode = node->m_deBruijnNode;
 
-    auto tags = m_graph->m_nodeTags.find(deBruijnNode);
-    if (tags != m_graph->m_nodeTags.end()) {
-        if (auto tag = gfa::getTag(m_tagName.c_str(), tags->second)) {
+    auto colour = m_nodeColours.find(deBruijnNode);
+    if (colour != m_nodeColours.end())
+        return colour->second;
+
+    return m_graph->getCustomColourForDisplay(deBruijnNode);
+}
+
+void TagValueNodeColorer::setTagName(const std::string &tagName) {
+    m_tagName = tagName;
+    updateNodeColours();
+}
+
+// Resolves the colours of all nodes having the current tag once, so get() is
+// a single lookup
+void TagValueNodeColorer::updateNodeColours() {
+    m_nodeColours.clear();
+    for (const auto &[node, tags] : m_graph->m_nodeTags) {
+        if (auto tag = gfa::getTag(m_tagName.c_str(), tags)) {
             std::stringstream stream;
             stream << *tag;
-            return m_allTags.at(stream.str());
+            m_nodeColours.emplace(node, m_allTags.at(stream.str()));
         }
     }
-
-    return m_graph->getCustomColourForDisplay(deBruijnNode);
 }
 
 void TagValueNodeColorer::reset() {
@@ -376,21 +391,48 @@ void TagValueNodeColorer::reset() {
 
     if (!m_tagNames.empty())
         m_tagName = *m_tagNames.begin();
+
+    updateNodeColours();
 }
 
 QColor CSVNodeColorer::get(const GraphicsItemNode *node) {
     const DeBruijnNode *deBruijnNode = node->m_deBruijnNode;
 
-    auto val = m_graph->getCsvLine(deBruijnNode, m_colIdx);
-    if (!val || m_colIdx >= m_colors.size())
-        return m_graph->getCustomColourForDisplay(deBruijnNode);
+    auto colour = m_nodeColours.find(deBruijnNode);
+    if (colour != m_nodeColours.end())
+        return colour->second;
+
+    // Nodes without CSV data have an empty value
+    if (m_emptyValueColour.isValid() && !m_graph->m_nodeCSVData.contains(deBruijnNode))
+        return m_emptyValueColour;
+
+    return m_graph->getCustomColourForDisplay(deBruijnNode);
+}
+
+void CSVNodeColorer::setColumnIdx(unsigned idx) {
+    m_colIdx = idx;
+    updateNodeColours();
+}
+
+// Resolves the colours of all nodes for the current column once, so get() is
+// a single lookup
+void CSVNodeColorer::updateNodeColours() {
+    m_nodeColours.clear();
+    m_emptyValueColour = QColor();
+    if (m_colIdx >= m_colors.size())
+        return;
 
     const auto &cols = m_colors[m_colIdx];
-    auto col = cols.find(val->toStdString());
-    if (col == cols.end())
-        return m_graph->getCustomColourForDisplay(deBruijnNode);
+    for (const auto &[node, row] : m_graph->m_nodeCSVData) {
+        auto val = m_graph->getCsvLine(node, m_colIdx);
+        auto col = cols.find(val->toStdString());
+        if (col != cols.end())
+            m_nodeColours.emplace(node, *col);
+    }
 
-    return *col;;
+    auto col = cols.find("");
+    if (col != cols.end())
+        m_emptyValueColour = *col;
 }
 
 void CSVNodeColorer::reset() {
@@ -421,4 +463,6 @@ void CSVNodeColorer::reset() {
             i += 1;
         }
     }
+
+    updateNodeColours();
 }
@@ -46,6 +46,8 @@ public:
     [[nodiscard]] virtual std::pair<QColor, QColor> get(const GraphicsItemNode *node,
                                                         const GraphicsItemNode *rcNode);
     virtual void reset() {};
+    // Called after nodes were created or destroyed, drops any per-node state
+    virtual void graphChanged() {};
     [[nodiscard]] virtual const char* name() const = 0;
 
     static std::unique_ptr<INodeColorer> create(NodeColorScheme scheme);
@@ -21,6 +21,7 @@
 #include "contiguity.h"
 
 #include <tsl/htrie_map.h>
+#include "parallel_hashmap/phmap.h"
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -105,9 +106,10 @@ public:
 
     QColor get(const GraphicsItemNode *node) override;
     void reset() override;
+    void graphChanged() override { updateNodeColours(); }
     [[nodiscard]] const char* name() const override { return "Color by tag value"; };
 
-    void setTagName(const std::string &tagName) { m_tagName = tagName; }
+    void setTagName(const std::string &tagName);
     [[nodiscard]] auto tagNames() const {
         std::vector<std::string> names(m_tagNames.begin(), m_tagNames.end());
         std::sort(names.begin(), names.end());
@@ -115,9 +117,12 @@ public:
     }
 
 private:
+    void updateNodeColours();
+
     std::string m_tagName = "";
     tsl::htrie_map<char, QColor> m_allTags;
     std::unordered_set<std::string> m_tagNames;
+    phmap::flat_hash_map<const DeBruijnNode*, QColor> m_nodeColours;
 };
 
 class CSVNodeColorer : public INodeColorer {
@@ -129,11 +134,16 @@ public:
     }
     QColor get(const GraphicsItemNode *node) override;
     void reset() override;
+    void graphChanged() override { updateNodeColours(); }
     [[nodiscard]] const char* name() const override { return "Color by CSV columns"; };
 
-    void setColumnIdx(unsigned idx) { m_colIdx = idx; }
+    void setColumnIdx(unsigned idx);
 
 private:
+    void updateNodeColours();
+
     unsigned m_colIdx = 0;
     std::vector<tsl::htrie_map<char, QColor>> m_colors;
+    phmap::flat_hash_map<const DeBruijnNode*, QColor> m_nodeColours;
+    QColor m_emptyValueColour;
 };
@@ -0,0 +1,89 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "nodemetrics.h"
+
+#include "assemblygraph.h"
+#include "debruijnedge.h"
+#include "debruijnnode.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <vector>
+
+namespace graph {
+
+static constexpr size_t NodesPerChunk = 16384;
+
+NodeMetrics computeNodeMetrics(const DeBruijnNode *node) {
+    NodeMetrics metrics;
+    metrics.gc = node->getGC();
+
+    int maxLeavingOverlap = 0;
+    for (const DeBruijnEdge *edge : node->edges()) {
+        int overlap = edge->getOverlap();
+        metrics.maxOverlap = std::max(metrics.maxOverlap, overlap);
+        if (edge->getStartingNode() == node) {
+            metrics.outDegree += 1;
+            maxLeavingOverlap = std::max(maxLeavingOverlap, overlap);
+        }
+        if (edge->getEndingNode() == node)
+            metrics.inDegree += 1;
+    }
+
+    int length = node->getLength();
+    metrics.trimmedLength = maxLeavingOverlap > length ? 0 : length - maxLeavingOverlap;
+
+    return metrics;
+}
+
+NodeMetrics NodeMetricsCache::compute(const DeBruijnNode *node) const {
+    NodeMetrics metrics = computeNodeMetrics(node);
+    metrics.depthFraction = float((node->getDepth() - m_lowDepth) / (m_highDepth - m_lowDepth));
+
+    return metrics;
+}
+
+void NodeMetricsCache::build(const AssemblyGraph &graph) {
+    clear();
+    m_lowDepth = graph.m_firstQuartileDepth;
+    m_highDepth = graph.m_thirdQuartileDepth;
+
+    // Self-complementary nodes are recorded twice in the node map
+    std::vector<const DeBruijnNode *> nodes(graph.m_deBruijnGraphNodes.begin(),
+                                            graph.m_deBruijnGraphNodes.end());
+    if (nodes.empty())
+        return;
+
+    std::vector<NodeMetrics> metrics(nodes.size());
+    std::vector<std::pair<size_t, size_t>> chunks;
+    for (size_t begin = 0; begin < nodes.size(); begin += NodesPerChunk)
+        chunks.emplace_back(begin, std::min(begin + NodesPerChunk, nodes.size()));
+
+    QtConcurrent::blockingMap(chunks, [&](const std::pair<size_t, size_t> &chunk) {
+        for (size_t i = chunk.first; i < chunk.second; ++i) {
+            metrics[i] = compute(nodes[i]);
+        }
+    });
+
+    m_metrics.reserve(nodes.size());
+    for (size_t i = 0; i < nodes.size(); ++i)
+        m_metrics.emplace(nodes[i], metrics[i]);
+}
+
+}
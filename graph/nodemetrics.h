@@ -0,0 +1,71 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "parallel_hashmap/phmap.h"
+
+class AssemblyGraph;
+class DeBruijnNode;
+
+namespace graph {
+
+// Per-node values derived from the node sequence, edges and depth
+struct NodeMetrics {
+    float gc = 0.0f;
+    // Position of the depth within the interquartile depth range of the graph:
+    // 0 at the first quartile, 1 at the third. Used by automatic depth colouring.
+    float depthFraction = 0.0f;
+    // Length without the largest overlap of the leaving edges
+    unsigned trimmedLength = 0;
+    // Largest overlap over all node edges
+    int maxOverlap = 0;
+    unsigned inDegree = 0, outDegree = 0;
+
+    [[nodiscard]] unsigned degree() const { return inDegree + outDegree; }
+};
+
+// Computes the metrics of a single node. Depth fraction requires the graph
+// depth quartiles and is left as zero.
+NodeMetrics computeNodeMetrics(const DeBruijnNode *node);
+
+// Metrics of all graph nodes. The cache is filled in parallel by
+// AssemblyGraph::determineGraphInfo() and cleared whenever nodes or edges are
+// changed, so colourers and statistics do not recompute them on every
+// redraw. Metrics of the nodes missing from the cache are computed on the fly.
+class NodeMetricsCache {
+  public:
+    void build(const AssemblyGraph &graph);
+    // Keeps the depth range of the last build for the metrics computed on the fly
+    void clear() { m_metrics.clear(); }
+
+    [[nodiscard]] bool empty() const { return m_metrics.empty(); }
+    [[nodiscard]] size_t size() const { return m_metrics.size(); }
+
+    [[nodiscard]] NodeMetrics get(const DeBruijnNode *node) const {
+        auto it = m_metrics.find(node);
+        return it != m_metrics.end() ? it->second : compute(node);
+    }
+
+  private:
+    [[nodiscard]] NodeMetrics compute(const DeBruijnNode *node) const;
+
+    phmap::flat_hash_map<const DeBruijnNode *, NodeMetrics> m_metrics;
+    double m_lowDepth = 0.0, m_highDepth = 0.0;
+};
+
+}
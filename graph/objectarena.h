@@ -0,0 +1,98 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "parallel_hashmap/phmap.h"
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Slab allocator for objects of a single type. Objects are never moved, so
+// pointers stay valid until the object is destroyed or the arena is cleared.
+// Memory of destroyed objects is reused by subsequent allocations and is
+// returned to the system only when the whole arena is cleared.
+template<class T, size_t SlabSize = 4096>
+class ObjectArena {
+  public:
+    ObjectArena() = default;
+    ObjectArena(const ObjectArena &) = delete;
+    ObjectArena &operator=(const ObjectArena &) = delete;
+
+    ~ObjectArena() { clear(); }
+
+    template<class... Args>
+    T *create(Args&&... args) {
+        T *ptr;
+        if (!freeList_.empty()) {
+            ptr = freeList_.back();
+            freeList_.pop_back();
+        } else {
+            if (slabs_.empty() || used_ == SlabSize) {
+                slabs_.push_back(std::allocator<T>().allocate(SlabSize));
+                used_ = 0;
+            }
+            ptr = slabs_.back() + used_++;
+        }
+
+        return new(ptr) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T *ptr) {
+        ptr->~T();
+        freeList_.push_back(ptr);
+    }
+
+    // Destroys all live objects and releases the memory
+    void clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            phmap::flat_hash_set<T*> destroyed(freeList_.begin(), freeList_.end());
+            for (size_t i = 0; i < slabs_.size(); ++i) {
+                size_t count = (i + 1 == slabs_.size() ? used_ : SlabSize);
+                for (T *ptr = slabs_[i], *end = ptr + count; ptr != end; ++ptr) {
+                    if (!destroyed.contains(ptr))
+                        ptr->~T();
+                }
+            }
+        }
+
+        for (T *slab : slabs_)
+            std::allocator<T>().deallocate(slab, SlabSize);
+
+        slabs_.clear();
+        freeList_.clear();
+        used_ = 0;
+    }
+
+    // Number of live objects
+    [[nodiscard]] size_t size() const {
+        size_t allocated = slabs_.empty() ? 0 : (slabs_.size() - 1) * SlabSize + used_;
+        return allocated - freeList_.size();
+    }
+
+  private:
+    std::vector<T*> slabs_;
+    std::vector<T*> freeList_;
+    size_t used_ = 0;
+};
+
+}
@@ -25,7 +25,10 @@
 #include <QRegularExpression>
 #include <QStringList>
 #include <QApplication>
+#include <functional>
 #include <limits>
+#include <queue>
+#include <unordered_map>
 #include <unordered_set>
 
 Path::Path(GraphLocation startLocation)
@@ -397,13 +400,19 @@ QByteArray Path::getPathSequence() const
 
     //The middle nodes are not affected by whether or not the path is circular
     //or has partial node ends.
+    //Node sequences are decoded directly into the result, skipping the
+    //overlapping part (same as utils::modifySequenceUsingOverlap).
     for (int i = 1; i < m_nodes.size(); ++i)
     {
         int overlap = m_edges[i-1]->getOverlap();
-        QByteArray nodeSequence = utils::sequenceToQByteArray(m_nodes[i]->getSequence());
-        if (overlap != 0)
-            nodeSequence = utils::modifySequenceUsingOverlap(nodeSequence, overlap);
-        sequence += nodeSequence;
+        const Sequence &nodeSequence = m_nodes[i]->getSequence();
+        if (overlap > 0 && size_t(overlap) <= nodeSequence.size())
+            utils::appendSequence(sequence, nodeSequence.Subseq(overlap));
+        else {
+            if (overlap < 0)
+                sequence.append(-overlap, 'N');
+            utils::appendSequence(sequence, nodeSequence);
+        }
     }
 
     DeBruijnNode * lastNode = m_nodes.back();
@@ -619,51 +628,140 @@ bool Path::hasNodeSubset(const Path& other) const {
 
 //This function builds all possible paths between the given start and end,
 //within the given restrictions.
+//Paths are enumerated depth-first with their lengths tracked incrementally.
+//Partial paths that cannot reach the end node within the remaining node depth,
+//or only with a length over maxDistance, are pruned using bounds precomputed by
+//searching backwards from the end node. Paths are returned in order of node
+//count and then of the edges taken, the same order as a breadth-first search.
 QList<Path> Path::getAllPossiblePaths(GraphLocation startLocation,
                                       GraphLocation endLocation,
                                       int nodeSearchDepth,
-                                      int minDistance, int maxDistance) {
-    QList<Path> finishedPaths;
-    QList<Path> unfinishedPaths;
+                                      int minDistance, int maxDistance,
+                                      bool *truncated) {
+    if (truncated)
+        *truncated = false;
+
+    DeBruijnNode *startNode = startLocation.getNode(), *endNode = endLocation.getNode();
+    if (startNode == nullptr || endNode == nullptr || nodeSearchDepth < 0)
+        return {};
 
-    unfinishedPaths.emplace_back(startLocation);
+    // For every node that can reach the end node within nodeSearchDepth edges,
+    // find the fewest edges and the smallest added length needed to get there.
+    struct DistanceToEnd {
+        int edges;
+        int64_t length;
+    };
+    std::unordered_map<const DeBruijnNode *, DistanceToEnd> toEnd;
+    toEnd[endNode] = { 0, 0 };
+
+    std::vector<const DeBruijnNode *> current{endNode}, next;
+    for (int depth = 1; depth <= nodeSearchDepth && !current.empty(); ++depth) {
+        for (const auto *node : current) {
+            for (const auto *edge : node->edges()) {
+                if (edge->getEndingNode() != node)
+                    continue;
+                const DeBruijnNode *prevNode = edge->getStartingNode();
+                if (toEnd.emplace(prevNode, DistanceToEnd{ depth, std::numeric_limits<int64_t>::max() }).second)
+                    next.push_back(prevNode);
+            }
+        }
+        current.swap(next);
+        next.clear();
+    }
 
-    for (int i = 0; i <= nodeSearchDepth; ++i)
+    // Shortest lengths are only valid lower bounds if extending a path never
+    // makes it shorter, i.e. no overlap exceeds the length of its node.
+    bool lengthBoundsValid = true;
     {
-        QApplication::processEvents();
-
-        //Look at each of the unfinished paths to see if they end with the end
-        //node.  If so, see if it has the appropriate length.
-        //If it does, it will go into the final returned list.
-        //If it doesn't and it's over length, then it will be removed.
-        QList<Path>::iterator j = unfinishedPaths.begin();
-        while (j != unfinishedPaths.end())
-        {
-            DeBruijnNode * lastNode = (*j).m_nodes.back();
-            if (lastNode == endLocation.getNode())
-            {
-                Path potentialFinishedPath = *j;
-                potentialFinishedPath.m_endLocation = endLocation;
-                int length = potentialFinishedPath.getLength();
-                if (length >= minDistance && length <= maxDistance)
-                    finishedPaths.push_back(potentialFinishedPath);
-                ++j;
+        using QueueEntry = std::pair<int64_t, const DeBruijnNode *>;
+        std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+        toEnd[endNode].length = 0;
+        queue.emplace(0, endNode);
+        while (!queue.empty() && lengthBoundsValid) {
+            auto [length, node] = queue.top();
+            queue.pop();
+            if (length > toEnd[node].length)
+                continue;
+
+            for (const auto *edge : node->edges()) {
+                if (edge->getEndingNode() != node)
+                    continue;
+                int64_t step = int64_t(node->getLength()) - edge->getOverlap();
+                if (step < 0) {
+                    lengthBoundsValid = false;
+                    break;
+                }
+
+                auto it = toEnd.find(edge->getStartingNode());
+                if (it == toEnd.end() || length + step >= it->second.length)
+                    continue;
+                it->second.length = length + step;
+                queue.emplace(length + step, it->first);
             }
-            else
-            {
-                if ((*j).getLength() > maxDistance)
-                    j = unfinishedPaths.erase(j);
-                else
-                    ++j;
+        }
+    }
+
+    if (!toEnd.count(startNode))
+        return {};
+
+    // Bases of the end node past the end location, which are not part of a
+    // finished path.
+    int64_t endTrim = int64_t(endNode->getLength()) - endLocation.getPosition();
+
+    std::vector<QList<Path>> finishedPathsByDepth(nodeSearchDepth + 1);
+    std::vector<DeBruijnNode *> nodes{startNode};
+    std::vector<DeBruijnEdge *> edges;
+    size_t candidates = 0;
+
+    auto search = [&](auto &self, DeBruijnNode *node, int64_t length) -> void {
+        if (++candidates > MaxPathSearchCandidates)
+            return;
+        if (candidates % 4096 == 0)
+            QApplication::processEvents();
+
+        int depth = int(edges.size());
+        if (node == endNode) {
+            int64_t finishedLength = length - endTrim;
+            if (finishedLength >= minDistance && finishedLength <= maxDistance) {
+                Path path(startLocation);
+                path.m_nodes = nodes;
+                path.m_edges = edges;
+                path.m_endLocation = endLocation;
+                finishedPathsByDepth[depth].push_back(std::move(path));
             }
+        } else if (length > maxDistance)
+            return;
+
+        if (depth == nodeSearchDepth)
+            return;
+
+        for (auto *edge : node->edges()) {
+            if (edge->getStartingNode() != node)
+                continue;
+
+            DeBruijnNode *nextNode = edge->getEndingNode();
+            auto it = toEnd.find(nextNode);
+            if (it == toEnd.end() || depth + 1 + it->second.edges > nodeSearchDepth)
+                continue;
+
+            int64_t nextLength = length + nextNode->getLength() - edge->getOverlap();
+            if (lengthBoundsValid && nextLength + it->second.length - endTrim > maxDistance)
+                continue;
+
+            nodes.push_back(nextNode);
+            edges.push_back(edge);
+            self(self, nextNode, nextLength);
+            nodes.pop_back();
+            edges.pop_back();
         }
+    };
+    search(search, startNode, int64_t(startNode->getLength()) - (startLocation.getPosition() - 1));
+    if (truncated)
+        *truncated = candidates > MaxPathSearchCandidates;
 
-        //Make new unfinished paths by extending each of the paths.
-        QList<Path> newUnfinishedPaths;
-        for (auto & unfinishedPath : unfinishedPaths)
-            newUnfinishedPaths.append(unfinishedPath.extendPathInAllPossibleWays());
-        unfinishedPaths = newUnfinishedPaths;
-    }
+    QList<Path> finishedPaths;
+    for (auto &paths : finishedPathsByDepth)
+        finishedPaths.append(std::move(paths));
 
     return finishedPaths;
 }
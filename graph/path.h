@@ -25,11 +25,14 @@
 #include <QList>
 #include <QString>
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 class DeBruijnNode;
 class DeBruijnEdge;
 class AssemblyGraph;
+namespace graph { class PathStore; }
 
 class Path {
 public:
@@ -99,12 +102,22 @@ public:
     void trim(int start = 0, int end = 0);
 
     //STATIC
+    // Upper bound on the number of partial paths explored by getAllPossiblePaths.
+    // Repeat-rich graphs can have exponentially many paths within the node and
+    // length limits, so the search stops once this many have been considered.
+    static constexpr size_t MaxPathSearchCandidates = 1000000;
+
+    // If truncated is given, it is set when the search hit MaxPathSearchCandidates
+    // and the returned list may be incomplete.
     static QList<Path> getAllPossiblePaths(GraphLocation startLocation,
                                            GraphLocation endLocation,
                                            int nodeSearchDepth,
-                                           int minDistance, int maxDistance);
+                                           int minDistance, int maxDistance,
+                                           bool *truncated = nullptr);
 
 private:
+    friend class graph::PathStore;
+
     GraphLocation m_startLocation;
     GraphLocation m_endLocation;
     std::vector<DeBruijnNode *> m_nodes;
@@ -117,7 +130,8 @@ struct Walk {
     std::string sampleId;
     unsigned seqStart, seqEnd;
     unsigned hapIndex;
-    Path walk;
+    // Walk nodes are kept in AssemblyGraph::m_walkStore
+    uint32_t pathId;
 };
 
 #endif // PATH_H
@@ -0,0 +1,119 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "parallel_hashmap/phmap.h"
+#include "llvm/ADT/iterator_range.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+class DeBruijnNode;
+
+namespace graph {
+
+// Inverted index from nodes to the paths (or walks) passing through them.
+// Paths are numbered in the iteration order of the path map and the ids of
+// the paths through every node are stored in one contiguous array (CSR
+// layout), so a lookup is a single hash probe and no per-node containers are
+// allocated. Entries refer back to the map, so path names are not copied. The
+// index has to be rebuilt after paths are added, as this invalidates the map
+// iterators.
+template<class Map>
+class PathIndex {
+  public:
+    using Entry = typename Map::const_iterator;
+
+    void clear() {
+        m_entries.clear();
+        m_pathIds.clear();
+        m_nodeRanges.clear();
+    }
+
+    // nodesOf(value) must return the node list of a path map value
+    template<class NodesOf>
+    void build(const Map &paths, NodesOf nodesOf) {
+        clear();
+
+        m_entries.reserve(paths.size());
+        for (auto it = paths.cbegin(); it != paths.cend(); ++it)
+            m_entries.push_back(it);
+
+        // Count the paths through every node. A path visiting a node several
+        // times is counted once.
+        for (uint32_t id = 0; id < m_entries.size(); ++id) {
+            for (const DeBruijnNode *node : nodesOf(*m_entries[id])) {
+                auto &range = m_nodeRanges[node];
+                if (range.lastPath != id) {
+                    ++range.end;
+                    range.lastPath = id;
+                }
+            }
+        }
+
+        uint32_t offset = 0;
+        for (auto &[node, range] : m_nodeRanges) {
+            range.begin = range.end = offset + range.end;
+            offset = range.begin;
+            range.lastPath = NoPath;
+        }
+
+        // Fill the ranges backwards, so they end up sorted by path id
+        m_pathIds.resize(offset);
+        for (uint32_t id = m_entries.size(); id-- > 0; ) {
+            for (const DeBruijnNode *node : nodesOf(*m_entries[id])) {
+                auto &range = m_nodeRanges[node];
+                if (range.lastPath != id) {
+                    m_pathIds[--range.begin] = id;
+                    range.lastPath = id;
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return m_entries.size(); }
+    [[nodiscard]] Entry entry(uint32_t id) const { return m_entries[id]; }
+    [[nodiscard]] std::string name(uint32_t id) const { return m_entries[id].key(); }
+    [[nodiscard]] const auto &value(uint32_t id) const { return *m_entries[id]; }
+
+    // Ids of the paths passing through the node, in increasing order
+    [[nodiscard]] auto pathsThrough(const DeBruijnNode *node) const {
+        auto it = m_nodeRanges.find(node);
+        if (it == m_nodeRanges.end())
+            return llvm::make_range(m_pathIds.data(), m_pathIds.data());
+
+        return llvm::make_range(m_pathIds.data() + it->second.begin,
+                                m_pathIds.data() + it->second.end);
+    }
+
+  private:
+    static constexpr uint32_t NoPath = std::numeric_limits<uint32_t>::max();
+
+    struct NodeRange {
+        uint32_t begin = 0, end = 0;
+        uint32_t lastPath = NoPath;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_pathIds;
+    phmap::flat_hash_map<const DeBruijnNode *, NodeRange> m_nodeRanges;
+};
+
+}
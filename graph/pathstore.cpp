@@ -0,0 +1,64 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pathstore.h"
+#include "path.h"
+
+#include <limits>
+#include <stdexcept>
+
+namespace graph {
+
+PathStore::Id PathStore::add(const Path &path) {
+    if (m_records.size() >= std::numeric_limits<Id>::max())
+        throw std::length_error("too many paths");
+
+    const auto &nodes = path.nodes();
+    m_nodes.insert(m_nodes.end(), nodes.begin(), nodes.end());
+    m_offsets.push_back(m_nodes.size());
+    m_records.push_back({ path.getStartLocation(), path.getEndLocation(),
+                          path.getLength(), path.isCircular() });
+
+    return Id(m_records.size() - 1);
+}
+
+void PathStore::clear() {
+    m_nodes.clear();
+    m_nodes.shrink_to_fit();
+    m_offsets.assign(1, 0);
+    m_offsets.shrink_to_fit();
+    m_records.clear();
+    m_records.shrink_to_fit();
+}
+
+Path PathStore::path(Id id) const {
+    auto range = nodes(id);
+    if (range.empty())
+        return {};
+
+    const Record &record = m_records[id];
+    Path res = Path::makeFromOrderedNodes(std::vector<DeBruijnNode *>(range.begin(), range.end()),
+                                         record.circular);
+    if (res.isEmpty())
+        return res;
+
+    res.m_startLocation = record.start;
+    res.m_endLocation = record.end;
+    return res;
+}
+
+}
@@ -0,0 +1,69 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "graphlocation.h"
+
+#include "llvm/ADT/iterator_range.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class DeBruijnNode;
+class Path;
+
+namespace graph {
+
+// Compact storage for the paths (or walks) loaded along with the graph. Node
+// lists of all paths are kept in one array with per-path offsets (CSR layout)
+// and edges are not stored at all: they are looked up again when a Path object
+// is materialized. Paths are identified by their insertion order.
+class PathStore {
+  public:
+    using Id = uint32_t;
+
+    Id add(const Path &path);
+    void clear();
+
+    [[nodiscard]] size_t size() const { return m_records.size(); }
+    [[nodiscard]] bool empty() const { return m_records.empty(); }
+
+    // Rebuilds the full Path object, this is linear in the path length
+    [[nodiscard]] Path path(Id id) const;
+
+    [[nodiscard]] auto nodes(Id id) const {
+        return llvm::make_range(m_nodes.data() + m_offsets[id],
+                                m_nodes.data() + m_offsets[id + 1]);
+    }
+    [[nodiscard]] size_t nodeCount(Id id) const { return m_offsets[id + 1] - m_offsets[id]; }
+    [[nodiscard]] int length(Id id) const { return m_records[id].length; }
+
+  private:
+    struct Record {
+        GraphLocation start, end;
+        int length;
+        bool circular;
+    };
+
+    std::vector<DeBruijnNode *> m_nodes;
+    std::vector<size_t> m_offsets = { 0 };
+    std::vector<Record> m_records;
+};
+
+}
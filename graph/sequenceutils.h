@@ -25,8 +25,16 @@
 
 namespace utils {
     static inline QByteArray sequenceToQByteArray(const Sequence &sequence) {
-        auto sequence_str = sequence.str();
-        return {sequence_str.c_str(), static_cast<qsizetype>(sequence_str.size())};
+        QByteArray res(static_cast<qsizetype>(sequence.size()), Qt::Uninitialized);
+        sequence.copyTo(res.data());
+        return res;
+    }
+
+    // Appends the sequence to the end of the array without intermediate copies
+    static inline void appendSequence(QByteArray &out, const Sequence &sequence) {
+        qsizetype size = out.size();
+        out.resize(size + static_cast<qsizetype>(sequence.size()));
+        sequence.copyTo(out.data() + size);
     }
 
     // This function is used when making FASTA outputs - it breaks a sequence into
@@ -26,5 +26,5 @@ class Query;
 class Hit;
     
 using NodeHits = std::vector<std::pair<Query*, Hit*>>;
-using PathHits = std::vector<std::tuple<Query*, const Path*, Path::MappingRange>>;
+using PathHits = std::vector<std::tuple<Query*, Path, Path::MappingRange>>;
 }
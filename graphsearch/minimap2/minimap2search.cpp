@@ -72,7 +72,7 @@ QString Minimap2Search::buildDatabase(const AssemblyGraph &graph, bool includePa
                 if (m_cancelBuildDatabase)
                     return (m_lastError = "Build cancelled.");
 
-                out << it.value().getFasta(it.key().c_str());
+                out << graph.getPath(*it).getFasta(it.key().c_str());
             }
         }
     }
@@ -183,7 +183,7 @@ buildHitsFromPAF(const QString &PAF,
 
         auto pathIt = g_assemblyGraph->m_deBruijnGraphPaths.find(nodeLabel.toStdString());
         if (pathIt != g_assemblyGraph->m_deBruijnGraphPaths.end()) {
-            pathHits.emplace_back(query, &pathIt.value(),
+            pathHits.emplace_back(query, g_assemblyGraph->getPath(*pathIt),
                                   Path::MappingRange{queryStart, queryEnd,
                                                      nodeStart, nodeEnd});
         }
@@ -205,10 +205,7 @@ void Queries::addNodeHits(const NodeHits &nodeHits) {
 
 void Queries::addPathHits(const PathHits &hits) {
     for (const auto &hit : hits) {
-        Query *query;
-        const Path *path;
-        Path::MappingRange range;
-        std::tie(query, path, range) = hit;
+        const auto &[query, path, range] = hit;
         std::vector<const Hit*> pathHits;
 
         int pathStart = range.mapped_range.from, pathEnd = range.mapped_range.to;
@@ -219,7 +216,7 @@ void Queries::addPathHits(const PathHits &hits) {
             std::swap(pathStart, pathEnd);
 
         std::vector<DeBruijnNode*> pathNodes;
-        for (auto entry: path->getNodeCovering(pathStart, pathEnd)) {
+        for (auto entry: path.getNodeCovering(pathStart, pathEnd)) {
             DeBruijnNode *node = entry.first;
             int nodeStart = entry.second.mapped_range.from, nodeEnd = entry.second.mapped_range.to;
             if (invert) {
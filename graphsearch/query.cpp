@@ -75,12 +75,14 @@ QString Query::getTypeString() const {
 
 void Query::clearSearchResults() {
     m_searchedFor = false;
+    m_pathSearchTruncated = false;
     m_hits.clear();
 }
 
 // This function tries to find the paths through the graph which cover the query.
 void Query::findQueryPaths() {
     m_paths.clear();
+    m_pathSearchTruncated = false;
     if (m_hits.size() > g_settings->maxHitsForQueryPath)
         return;
 
@@ -147,11 +149,14 @@ void Query::findQueryPaths() {
             else //neither are on
                 maxLength = std::numeric_limits<int>::max();
 
+            bool truncated = false;
             possiblePaths.append(Path::getAllPossiblePaths(startLocation,
                                                            endLocation,
                                                            g_settings->maxQueryPathNodes - 1,
                                                            minLength,
-                                                           maxLength));
+                                                           maxLength,
+                                                           &truncated));
+            m_pathSearchTruncated |= truncated;
         }
     }
 
@@ -55,6 +55,9 @@ namespace search {
 
         const auto &getPaths() const { return m_paths; }
         size_t getPathCount() const { return m_paths.size(); }
+        // True if the path search stopped at Path::MaxPathSearchCandidates for some
+        // pair of hits, so the paths found may be incomplete
+        bool isPathSearchTruncated() const { return m_pathSearchTruncated; }
 
         QString getTypeString() const;
 
@@ -94,6 +97,7 @@ namespace search {
         bool m_shown = true;
         QColor m_colour;
         std::vector<QueryPath> m_paths;
+        bool m_pathSearchTruncated = false;
 
         void autoSetSequenceType();
     };
@@ -17,7 +17,8 @@
 
 #pragma once
 
-#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
 
 #include <QColor>
@@ -44,11 +45,12 @@ namespace bed {
         int64_t start, end;
     };
 
+    // Strings refer to the text of the parsed line
     struct Line {
-        std::string chrom{};
+        std::string_view chrom{};
         int64_t chromStart = 0;
         int64_t chromEnd = 0;
-        std::string name{};
+        std::string_view name{};
         int score = 0;
         Strand strand = Strand::UNKNOWN;
         int64_t thickStart = -1;
@@ -17,125 +17,198 @@
 
 #include "bedloader.h"
 
-#include <csv/csv.hpp>
+#include <zlib.h>
 
-#include <sstream>
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 
 namespace bed {
 
-static std::vector<int64_t> parseIntArray(const std::string &intArrayString) {
-    std::stringstream ss{intArrayString};
-    std::string intString;
-    std::vector<int64_t> res;
-    while (std::getline(ss, intString, ',')) {
-        if (intString.empty()) {
+template<class T>
+static bool parseNumber(std::string_view field, T &value) {
+    const char *end = field.data() + field.size();
+    auto [ptr, ec] = std::from_chars(field.data(), end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+template<class T>
+static T parseNumber(std::string_view field, const char *column) {
+    T value{};
+    if (!parseNumber(field, value))
+        throw std::logic_error(std::string("Invalid ") + column + ": '" + std::string(field) + "'");
+    return value;
+}
+
+// Takes the next value from a comma-separated list, trailing comma is allowed
+static bool nextListValue(std::string_view &list, int64_t &value, const char *column) {
+    if (list.empty())
+        return false;
+
+    size_t comma = list.find(',');
+    value = parseNumber<int64_t>(list.substr(0, comma), column);
+    list.remove_prefix(comma == std::string_view::npos ? list.size() : comma + 1);
+    return true;
+}
+
+bool parseLine(std::string_view line, Line &bedLine) {
+    if (line.empty() || line.front() == '#' ||
+        line.substr(0, 5) == "track" || line.substr(0, 7) == "browser")
+        return false;
+
+    constexpr size_t MaxFields = 12;
+    std::string_view fields[MaxFields];
+    size_t fieldCount = 0;
+    while (fieldCount < MaxFields) {
+        size_t tab = line.find('\t');
+        fields[fieldCount++] = line.substr(0, tab);
+        if (tab == std::string_view::npos)
             break;
-        }
-        res.push_back(std::stoll(intString));
+        line.remove_prefix(tab + 1);
     }
-    return res;
-}
 
-std::vector<Line> load(const std::filesystem::path &path) {
-    csv::CSVFormat format;
-    format.delimiter('\t')
-          .quote('"')
-          .no_header();  // Parse TSVs without a header row
-    format.column_names({
-            "chrom", "chromStart", "chromEnd",
-            "name", "score", "strand",
-            "thickStart", "thinkEnd",
-            "itemRgb", "blockCount",
-            "blockSizes", "blockStarts"
-        });
-    csv::CSVReader csvReader(path.string(), format);
-
-    csv::CSVRow row;
-    std::vector<Line> res;
-    while (csvReader.read_row(row)) {
-        // At least 3 columns are mandatory
-        if (row.size() < 3)
-            throw std::logic_error("Mandatory columns were not found");
-
-        Line bedLine;
-        std::string itemRgbString = "0";
-        int64_t blockCount = 0;
-        std::string blockSizesString;
-        std::string blockStartsString;
-        for (size_t i = 0; i < row.size(); ++i) {
-            auto cell = row[i];
-            switch (i) {
-            default:
-                break;
-            case 0:
-                bedLine.chrom = cell.get();
-                break;
-            case 1:
-                bedLine.chromStart = cell.get<int64_t>();
-                break;
-            case 2:
-                bedLine.chromEnd = cell.get<int64_t>();
-                break;
-            case 3:
-                bedLine.name = cell.get();
-                break;
-            case 4:
-                bedLine.score = cell.is_int() ? cell.get<int>() : 0;
-                break;
-            case 5:
-                bedLine.strand = Strand{cell.get()[0]};
-                break;
-            case 6:
-                bedLine.thickStart = cell.get<int64_t>();
-                break;
-            case 7:
-                bedLine.thickEnd = cell.get<int64_t>();
-                break;
-            case 8:
-                itemRgbString = cell.get();
-                break;
-            case 9:
-                blockCount = cell.get<int64_t>();
-                break;
-            case 10:
-                blockSizesString = cell.get();
-                break;
-            case 11:
-                blockStartsString = cell.get();
-                break;
-            }
-        }
+    // At least 3 columns are mandatory
+    if (fieldCount < 3)
+        throw std::logic_error("Mandatory columns were not found");
+
+    bedLine.chrom = fields[0];
+    bedLine.chromStart = parseNumber<int64_t>(fields[1], "chromStart");
+    bedLine.chromEnd = parseNumber<int64_t>(fields[2], "chromEnd");
+    bedLine.name = fieldCount > 3 ? fields[3] : std::string_view();
+    bedLine.score = 0;
+    if (fieldCount > 4)
+        parseNumber(fields[4], bedLine.score);
+    bedLine.strand = fieldCount > 5 && !fields[5].empty() ? Strand{fields[5].front()} : Strand::UNKNOWN;
+    bedLine.thickStart = fieldCount > 6 ? parseNumber<int64_t>(fields[6], "thickStart") : -1;
+    bedLine.thickEnd = fieldCount > 7 ? parseNumber<int64_t>(fields[7], "thickEnd") : -1;
+    if (bedLine.thickStart == -1 || bedLine.thickEnd == -1) {
+        bedLine.thickStart = bedLine.chromStart;
+        bedLine.thickEnd = bedLine.chromEnd;
+    }
 
-        if (bedLine.thickStart == -1 || bedLine.thickEnd == -1) {
-            bedLine.thickStart = bedLine.chromStart;
-            bedLine.thickEnd = bedLine.chromEnd;
+    std::string_view itemRgb = fieldCount > 8 ? fields[8] : "0";
+    if (itemRgb != "0") {
+        int64_t rgb[3];
+        for (auto &component : rgb) {
+            if (!nextListValue(itemRgb, component, "itemRgb"))
+                throw std::logic_error("Invalid itemRgb: expected 3 components");
         }
+        bedLine.itemRgb = { uint8_t(rgb[0]), uint8_t(rgb[1]), uint8_t(rgb[2]) };
+    } else {
+        bedLine.itemRgb = { uint8_t(rand() & 0xFF), uint8_t(rand() & 0xFF), uint8_t(rand() & 0xFF) };
+    }
 
-        {
-            std::vector<int64_t> rgbArray;
-            if (itemRgbString != "0") {
-                rgbArray = parseIntArray(itemRgbString);
-            } else {
-                rgbArray = { rand() & 0xFF, rand() & 0xFF, rand() & 0xFF };
-            }
-            bedLine.itemRgb.r = rgbArray[0];
-            bedLine.itemRgb.g = rgbArray[1];
-            bedLine.itemRgb.b = rgbArray[2];
-        }
+    bedLine.blocks.clear();
+    int64_t blockCount = fieldCount > 9 ? parseNumber<int64_t>(fields[9], "blockCount") : 0;
+    std::string_view blockSizes = fieldCount > 10 ? fields[10] : std::string_view();
+    std::string_view blockStarts = fieldCount > 11 ? fields[11] : std::string_view();
+    for (int64_t i = 0; i < blockCount; ++i) {
+        int64_t blockSize, blockStart;
+        if (!nextListValue(blockSizes, blockSize, "blockSizes") ||
+            !nextListValue(blockStarts, blockStart, "blockStarts"))
+            throw std::logic_error("Block lists are shorter than blockCount");
+
+        blockStart += bedLine.chromStart;
+        bedLine.blocks.push_back(Block{blockStart, blockStart + blockSize});
+    }
 
-        if (blockCount != 0) {
-            auto blockSizes = parseIntArray(blockSizesString);
-            auto blockStarts = parseIntArray(blockStartsString);
-            for (int i = 0; i < blockCount; i++) {
-                auto blockStart = bedLine.chromStart + blockStarts[i];
-                auto blockEnd = blockStart + blockSizes[i];
-                bedLine.blocks.push_back(Block{.start = blockStart, .end = blockEnd});
+    return true;
+}
+
+// See the tabix format specification (SAMv1 document set, section 5.2)
+std::optional<TabixIndex> TabixIndex::load(const QString &fileName) {
+    gzFile fp = gzopen(fileName.toStdString().c_str(), "r");
+    if (!fp)
+        return std::nullopt;
+
+    // The whole index is read into memory, it is small
+    std::vector<char> data;
+    constexpr unsigned ReadSize = 1024 * 1024;
+    int read;
+    do {
+        size_t pos = data.size();
+        data.resize(pos + ReadSize);
+        read = gzread(fp, data.data() + pos, ReadSize);
+        data.resize(pos + std::max(read, 0));
+    } while (read == int(ReadSize));
+    gzclose(fp);
+    if (read < 0)
+        return std::nullopt;
+
+    size_t pos = 0;
+    bool truncated = false;
+    auto take = [&](auto &value) {
+        if (pos + sizeof(value) > data.size()) {
+            truncated = true;
+            value = {};
+            return;
+        }
+        std::memcpy(&value, data.data() + pos, sizeof(value));
+        pos += sizeof(value);
+    };
+
+    if (data.size() < 4 || std::memcmp(data.data(), "TBI\1", 4) != 0)
+        return std::nullopt;
+    pos = 4;
+
+    int32_t refCount, format, colSeq, colBeg, colEnd, meta, skip, namesLength;
+    take(refCount); take(format); take(colSeq); take(colBeg); take(colEnd);
+    take(meta); take(skip); take(namesLength);
+    if (truncated || refCount < 0 || namesLength < 0 || pos + namesLength > data.size())
+        return std::nullopt;
+
+    std::vector<std::string_view> names;
+    for (const char *p = data.data() + pos, *e = p + namesLength; p < e; ) {
+        const char *nul = std::find(p, e, '\0');
+        names.emplace_back(p, nul - p);
+        p = nul + 1;
+    }
+    pos += namesLength;
+    if (names.size() != size_t(refCount))
+        return std::nullopt;
+
+    // Bin that holds the sequence metadata rather than feature chunks
+    constexpr uint32_t PseudoBin = 37450;
+
+    TabixIndex index;
+    for (int32_t ref = 0; ref < refCount; ++ref) {
+        uint64_t offset = std::numeric_limits<uint64_t>::max();
+        int32_t binCount;
+        take(binCount);
+        for (int32_t bin = 0; bin < binCount && !truncated; ++bin) {
+            uint32_t binId;
+            int32_t chunkCount;
+            take(binId); take(chunkCount);
+            for (int32_t chunk = 0; chunk < chunkCount && !truncated; ++chunk) {
+                uint64_t chunkBegin, chunkEnd;
+                take(chunkBegin); take(chunkEnd);
+                if (binId != PseudoBin)
+                    offset = std::min(offset, chunkBegin);
             }
         }
-        res.emplace_back(bedLine);
+
+        int32_t intervalCount;
+        take(intervalCount);
+        pos += size_t(std::max(intervalCount, 0)) * sizeof(uint64_t);
+        if (truncated || pos > data.size())
+            return std::nullopt;
+
+        if (offset != std::numeric_limits<uint64_t>::max())
+            index.offsets_.emplace(names[ref], offset);
     }
 
-    return res;
+    return index;
+}
+
+std::optional<uint64_t> TabixIndex::offset(std::string_view chrom) const {
+    auto it = offsets_.find(chrom);
+    if (it == offsets_.end())
+        return std::nullopt;
+
+    return it->second;
 }
 
 }
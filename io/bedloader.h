@@ -18,10 +18,36 @@
 #pragma once
 
 #include "bed.h"
-#include <filesystem>
+
+#include "parallel_hashmap/phmap.h"
+
+#include <QString>
+
+#include <optional>
+#include <string>
+#include <string_view>
 
 namespace bed {
 
-std::vector<Line> load(const std::filesystem::path &path);
+// Splits a single line into fields in place, nothing is copied. Returns false
+// for lines that do not describe a feature (comments, track and browser
+// lines). Throws std::logic_error on malformed lines.
+bool parseLine(std::string_view line, Line &bedLine);
+
+// Tabix index of a bgzip-compressed BED file. Only the start of every
+// sequence is kept, as all features of a node are always loaded together.
+class TabixIndex {
+  public:
+    // Returns std::nullopt if the index cannot be read
+    static std::optional<TabixIndex> load(const QString &fileName);
+
+    // Virtual offset of the first feature of the sequence
+    [[nodiscard]] std::optional<uint64_t> offset(std::string_view chrom) const;
+
+    [[nodiscard]] const auto &offsets() const { return offsets_; }
+
+  private:
+    phmap::flat_hash_map<std::string, uint64_t> offsets_;
+};
 
 }
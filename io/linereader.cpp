@@ -0,0 +1,284 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "linereader.h"
+
+#include <QFile>
+
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+namespace io {
+
+void LineChunk::splitLines(const char *p, const char *e) {
+    while (p < e) {
+        const char *nl = static_cast<const char*>(std::memchr(p, '\n', e - p));
+        const char *le = nl ? nl : e;
+        size_t len = le - p;
+        // Handle CRLF line endings
+        if (len && p[len - 1] == '\r')
+            len -= 1;
+        // Skip empty lines
+        if (len)
+            lines.emplace_back(p, len);
+        p = nl ? nl + 1 : e;
+    }
+}
+
+namespace {
+// Reads the input in large blocks instead of going character-by-character and
+// splits it into lines. Subclasses provide the (decompressed) blocks.
+class BlockReader : public LineReader {
+  public:
+    explicit BlockReader(unsigned blockSize = BlockSize)
+            : blockSize_(blockSize) {}
+
+    bool read(LineChunk &chunk) override {
+        chunk.clear();
+        if (error_)
+            return false;
+
+        auto &buf = chunk.buffer;
+        buf.swap(tail_);
+        while (!eof_) {
+            size_t pos = buf.size();
+            buf.resize(pos + blockSize_);
+            int read = readBlock(buf.data() + pos, blockSize_);
+            if (read < 0) {
+                error_ = true;
+                return false;
+            }
+            buf.resize(pos + read);
+            bytes_ += read;
+            if (unsigned(read) < blockSize_)
+                eof_ = true;
+
+            // Stop as soon as we have at least one complete line
+            if (std::memchr(buf.data() + pos, '\n', read))
+                break;
+        }
+
+        // Carry incomplete last line over to the next chunk
+        if (!eof_) {
+            size_t end = buf.size();
+            while (end > 0 && buf[end - 1] != '\n')
+                --end;
+            tail_.assign(buf.begin() + end, buf.end());
+            buf.resize(end);
+        }
+
+        chunk.splitLines(buf.data(), buf.data() + buf.size());
+        return !buf.empty();
+    }
+
+    bool rewind() override {
+        tail_.clear();
+        eof_ = false;
+        return restart();
+    }
+
+  protected:
+    // Returns the number of bytes read (less than size only at the end of the
+    // input) or -1 on error
+    virtual int readBlock(char *buf, unsigned size) = 0;
+    virtual bool restart() = 0;
+
+  private:
+    unsigned blockSize_;
+    std::vector<char> tail_;
+    bool eof_ = false;
+};
+
+// Reads plain or gzip-compressed input through zlib
+class GzipReader : public BlockReader {
+  public:
+    explicit GzipReader(gzFile fp)
+            : fp_(fp) {
+        gzbuffer(fp_, 1024 * 1024);
+    }
+
+    ~GzipReader() override {
+        gzclose(fp_);
+    }
+
+  protected:
+    int readBlock(char *buf, unsigned size) override {
+        return gzread(fp_, buf, size);
+    }
+
+    bool restart() override {
+        return gzrewind(fp_) == 0;
+    }
+
+  private:
+    gzFile fp_;
+};
+
+// Reads BGZF input (a series of gzip members, as produced by bgzip) starting
+// from a virtual offset: the upper 48 bits are the file offset of a member,
+// the lower 16 bits are the offset within its decompressed data.
+class BgzfReader : public BlockReader {
+  public:
+    // BGZF members are at most 64k, so are the blocks here: usually only a
+    // small region is read
+    static constexpr unsigned BgzfBlockSize = 64 * 1024;
+
+    static std::unique_ptr<BgzfReader> open(const QString &fileName, uint64_t virtualOffset) {
+        std::unique_ptr<BgzfReader> reader(new BgzfReader(fileName, virtualOffset));
+        if (!reader->file_.open(QIODevice::ReadOnly) ||
+            inflateInit2(&reader->stream_, 15 + 16) != Z_OK)
+            return nullptr;
+
+        reader->initialized_ = true;
+        if (!reader->restart())
+            return nullptr;
+
+        return reader;
+    }
+
+    ~BgzfReader() override {
+        if (initialized_)
+            inflateEnd(&stream_);
+    }
+
+  protected:
+    int readBlock(char *buf, unsigned size) override {
+        stream_.next_out = reinterpret_cast<Bytef*>(buf);
+        stream_.avail_out = size;
+        while (stream_.avail_out) {
+            if (!stream_.avail_in) {
+                qint64 read = file_.read(input_.data(), qint64(input_.size()));
+                if (read < 0)
+                    return -1;
+                if (read == 0)
+                    break;
+                stream_.next_in = reinterpret_cast<Bytef*>(input_.data());
+                stream_.avail_in = uInt(read);
+            }
+
+            int ret = inflate(&stream_, Z_NO_FLUSH);
+            // Continue with the next member
+            if (ret == Z_STREAM_END)
+                ret = inflateReset(&stream_);
+            if (ret != Z_OK)
+                return -1;
+        }
+
+        return int(size - stream_.avail_out);
+    }
+
+    bool restart() override {
+        if (!file_.seek(qint64(virtualOffset_ >> 16)) || inflateReset(&stream_) != Z_OK)
+            return false;
+        stream_.avail_in = 0;
+
+        // Skip to the start of the record within the member
+        unsigned skip = virtualOffset_ & 0xFFFF;
+        std::vector<char> skipped(skip);
+        return skip == 0 || readBlock(skipped.data(), skip) == int(skip);
+    }
+
+  private:
+    BgzfReader(const QString &fileName, uint64_t virtualOffset)
+            : BlockReader(BgzfBlockSize), file_(fileName), virtualOffset_(virtualOffset), input_(BgzfBlockSize) {}
+
+    QFile file_;
+    uint64_t virtualOffset_;
+    std::vector<char> input_;
+    z_stream stream_{};
+    bool initialized_ = false;
+};
+
+// Parses uncompressed input directly over the memory-mapped file, so lines
+// are never copied. The mapping is owned by the QFile and stays alive until
+// the reader is destroyed.
+class MappedReader : public LineReader {
+  public:
+    static std::unique_ptr<MappedReader> open(const QString &fileName) {
+        std::unique_ptr<MappedReader> reader(new MappedReader(fileName));
+        if (!reader->file_.open(QIODevice::ReadOnly))
+            return nullptr;
+
+        qint64 size = reader->file_.size();
+        if (size < 2)
+            return nullptr;
+
+        const uchar *data = reader->file_.map(0, size);
+        if (!data)
+            return nullptr;
+
+        // Leave compressed files to zlib
+        if (data[0] == 0x1f && data[1] == 0x8b)
+            return nullptr;
+
+        reader->begin_ = reinterpret_cast<const char*>(data);
+        reader->end_ = reader->begin_ + size;
+        reader->pos_ = reader->begin_;
+        return reader;
+    }
+
+    bool read(LineChunk &chunk) override {
+        chunk.clear();
+        if (pos_ == end_)
+            return false;
+
+        // Extend the block up to the end of the line
+        const char *end = pos_ + std::min<size_t>(BlockSize, end_ - pos_);
+        if (end != end_) {
+            if (auto *nl = static_cast<const char*>(std::memchr(end, '\n', end_ - end)))
+                end = nl + 1;
+            else
+                end = end_;
+        }
+
+        chunk.splitLines(pos_, end);
+        bytes_ += end - pos_;
+        pos_ = end;
+        return true;
+    }
+
+    bool rewind() override {
+        pos_ = begin_;
+        return true;
+    }
+
+  private:
+    explicit MappedReader(const QString &fileName)
+            : file_(fileName) {}
+
+    QFile file_;
+    const char *begin_ = nullptr, *end_ = nullptr, *pos_ = nullptr;
+};
+}
+
+std::unique_ptr<LineReader> LineReader::open(const QString &fileName) {
+    if (auto reader = MappedReader::open(fileName))
+        return reader;
+
+    gzFile fp = gzopen(fileName.toStdString().c_str(), "r");
+    if (!fp)
+        return nullptr;
+
+    return std::make_unique<GzipReader>(fp);
+}
+
+std::unique_ptr<LineReader> LineReader::openBgzf(const QString &fileName, uint64_t virtualOffset) {
+    return BgzfReader::open(fileName, virtualOffset);
+}
+
+}
@@ -0,0 +1,72 @@
+// Copyright 2026 Anton Korobeynikov
+
+// This file is part of Bandage-NG
+
+// Bandage-NG is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Bandage-NG is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with Bandage.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QString>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace io {
+
+// A chunk of the input that consists of complete lines only. The lines refer
+// to the chunk data (either the chunk own buffer or the mapped file), so it
+// needs to be kept alive until all lines are processed.
+struct LineChunk {
+    std::vector<char> buffer;
+    std::vector<std::string_view> lines;
+
+    void clear() {
+        buffer.clear();
+        lines.clear();
+    }
+
+    void splitLines(const char *p, const char *e);
+};
+
+// Reads the input in large chunks of complete lines.
+class LineReader {
+  public:
+    static constexpr unsigned BlockSize = 16 * 1024 * 1024;
+
+    // Uncompressed files are read straight from the mapped memory, everything
+    // else is decompressed block-by-block. Returns nullptr if the file cannot
+    // be opened.
+    static std::unique_ptr<LineReader> open(const QString &fileName);
+    // Reads a BGZF-compressed file starting from the given virtual offset (as
+    // stored in tabix indices) till the end of the file.
+    static std::unique_ptr<LineReader> openBgzf(const QString &fileName, uint64_t virtualOffset);
+
+    virtual ~LineReader() = default;
+
+    // Returns false when there is nothing more to read
+    virtual bool read(LineChunk &chunk) = 0;
+    // Restarts reading from the beginning of the input
+    virtual bool rewind() = 0;
+
+    [[nodiscard]] bool error() const { return error_; }
+    [[nodiscard]] size_t bytesRead() const { return bytes_; }
+
+  protected:
+    size_t bytes_ = 0;
+    bool error_ = false;
+};
+
+}
@@ -23,7 +23,6 @@
 
 #include "program/settings.h"
 
-#include "ogdf/basic/GraphCopy.h"
 #include "ogdf/basic/simple_graph_alg.h"
 #include "ogdf/energybased/FMMMLayout.h"
 #include "ogdf/energybased/fmmm/MAARPacking.h"
@@ -31,9 +30,17 @@
 #include "ogdf/energybased/fmmm/FMMMOptions.h"
 
 #include <QFutureSynchronizer>
+#include <QMutexLocker>
+#include <QThread>
 #include <QtConcurrent>
 
+#include <atomic>
+#include <cmath>
 #include <ctime>
+#include <deque>
+#include <limits>
+#include <numeric>
+#include <random>
 
 GraphLayouter::GraphLayouter(int graphLayoutQuality, bool useLinearLayout,
                              double graphLayoutComponentSeparation, double aspectRatio)
@@ -101,14 +108,91 @@ private:
                 layout.nmPrecision(8);
                 break;
         }
+
+        if (m_incremental) {
+            // Refine the initial positions: no multilevel coarsening and no
+            // rotation of the component, so the drawing stays recognizable
+            layout.initialPlacementForces(ogdf::FMMMOptions::InitialPlacementForces::KeepPositions);
+            layout.minGraphSize(std::numeric_limits<int>::max());
+            layout.stepsForRotatingComponents(0);
+            layout.tipOverCCs(ogdf::FMMMOptions::TipOver::None);
+            layout.fixedIterations(std::max(layout.fixedIterations() / 4, 1));
+            layout.fineTuningIterations(layout.fineTuningIterations() / 4);
+        }
     }
 
     ogdf::FMMMLayout m_layout;
 };
 
-GraphLayoutWorker::GraphLayoutWorker(int graphLayoutQuality, bool useLinearLayout,
+// Fast multipole embedder. It is multithreaded and its memory usage is linear
+// in the graph size, so it is suitable for huge graphs where FMMM is too slow.
+class FastMultipoleGraphLayout : public GraphLayouter {
+public:
+    using GraphLayouter::GraphLayouter;
+
+    // Components larger than this (in OGDF nodes) are laid out using all cores
+    static constexpr int MultithreadedComponentSize = 50000;
+
+    void init() override {
+        m_layout.setRandomize(!m_useLinearLayout && !m_incremental);
+        m_layout.setDefaultEdgeLength(1.0);
+
+        unsigned iterations = 100;
+        switch (m_graphLayoutQuality) {
+            case 0:
+                iterations = 25;
+                m_layout.setMultipolePrec(2);
+                break;
+            case 1:
+                iterations = 50;
+                m_layout.setMultipolePrec(2);
+                break;
+            case 2:
+                iterations = 100;
+                m_layout.setMultipolePrec(4);
+                break;
+            case 3:
+                iterations = 200;
+                m_layout.setMultipolePrec(6);
+                break;
+            case 4:
+                iterations = 400;
+                m_layout.setMultipolePrec(8);
+                break;
+        }
+
+        m_layout.setNumIterations(m_incremental ? std::max(iterations / 4, 1u) : iterations);
+    }
+
+    void cancel() override {
+        m_layout.setNumIterations(0);
+    }
+
+    void run(ogdf::GraphAttributes &GA, const ogdf::EdgeArray<double> &edges) override {
+        const ogdf::Graph &G = GA.constGraph();
+
+        ogdf::NodeArray<float> nodeSizes(G);
+        for (ogdf::node v : G.nodes)
+            nodeSizes[v] = float(std::max(GA.width(v), GA.height(v)) / 2);
+
+        ogdf::EdgeArray<float> edgeLengths(G);
+        for (ogdf::edge e : G.edges)
+            edgeLengths[e] = float(edges[e]);
+
+        m_layout.setNumberOfThreads(G.numberOfNodes() > MultithreadedComponentSize ?
+                                    std::max(QThread::idealThreadCount(), 1) : 1);
+        m_layout.call(GA, edgeLengths, nodeSizes);
+    }
+
+private:
+    ogdf::FastMultipoleEmbedder m_layout;
+};
+
+GraphLayoutWorker::GraphLayoutWorker(GraphLayoutAlgorithm graphLayoutAlgorithm,
+                                     int graphLayoutQuality, bool useLinearLayout,
                                      double graphLayoutComponentSeparation, double aspectRatio)
-        : m_graphLayoutQuality(graphLayoutQuality),
+        : m_graphLayoutAlgorithm(graphLayoutAlgorithm),
+          m_graphLayoutQuality(graphLayoutQuality),
           m_useLinearLayout(useLinearLayout),
           m_graphLayoutComponentSeparation(graphLayoutComponentSeparation),
           m_aspectRatio(aspectRatio) {}
@@ -493,16 +577,13 @@ rotateComponentsAndCalculateBoundingRectangles(
 
 static void reassembleDrawings(ogdf::GraphAttributes &GA,
                                double graphLayoutComponentSeparation, double aspectRatio,
-                               const ogdf::Array<ogdf::List<ogdf::node> > &nodesInCC) {
-#if 0
-    auto R =
-            calculateBoundingRectanglesOfComponents(GA, nodesInCC,
-                                                    graphLayoutComponentSeparation);
-#else
-    auto R =
-            rotateComponentsAndCalculateBoundingRectangles(GA, nodesInCC,
-                                                           graphLayoutComponentSeparation, aspectRatio);
-#endif
+                               const ogdf::Array<ogdf::List<ogdf::node> > &nodesInCC,
+                               bool rotateComponents = true) {
+    auto R = rotateComponents ?
+             rotateComponentsAndCalculateBoundingRectangles(GA, nodesInCC,
+                                                            graphLayoutComponentSeparation, aspectRatio) :
+             calculateBoundingRectanglesOfComponents(GA, nodesInCC,
+                                                     graphLayoutComponentSeparation);
 
     double aspect_ratio_area, bounding_rectangles_area;
     fmmm::MAARPacking().pack_rectangles_using_Best_Fit_strategy(R, aspectRatio,
@@ -531,6 +612,159 @@ static void reassembleDrawings(ogdf::GraphAttributes &GA,
     }
 }
 
+// Copies a single connected component into a standalone graph, lays it out
+// and writes the positions back. Unlike GraphCopy (which allocates arrays
+// over the whole original graph), the cost here is proportional to the
+// component size only.
+static void layoutComponent(GraphLayouter &layouter,
+                            ogdf::GraphAttributes &GA, const ogdf::EdgeArray<double> &edgeLengths,
+                            const ogdf::List<ogdf::node> &nodesInCC,
+                            const ogdf::NodeArray<int> &indexInCC) {
+    ogdf::Graph C;
+    std::vector<ogdf::node> copies;
+    copies.reserve(nodesInCC.size());
+    for (int i = 0; i < nodesInCC.size(); ++i)
+        copies.push_back(C.newNode());
+
+    ogdf::GraphAttributes cGA(C, GA.attributes());
+    ogdf::EdgeArray<double> cEdgeLengths(C);
+    for (ogdf::node v : nodesInCC) {
+        ogdf::node cv = copies[indexInCC[v]];
+        cGA.x(cv) = GA.x(v);
+        cGA.y(cv) = GA.y(v);
+        cGA.width(cv) = GA.width(v);
+        cGA.height(cv) = GA.height(v);
+
+        for (ogdf::adjEntry adj : v->adjEntries) {
+            if (!adj->isSource())
+                continue;
+
+            ogdf::edge e = adj->theEdge();
+            ogdf::edge ce = C.newEdge(cv, copies[indexInCC[e->target()]]);
+            cEdgeLengths[ce] = edgeLengths[e];
+        }
+    }
+
+    layouter.run(cGA, cEdgeLengths);
+
+    for (ogdf::node v : nodesInCC) {
+        ogdf::node cv = copies[indexInCC[v]];
+        GA.x(v) = cGA.x(cv);
+        GA.y(v) = cGA.y(cv);
+    }
+}
+
+// Resamples the polyline of a previously drawn node at t in [0, 1]
+static QPointF interpolateSegments(const adt::SmallPODVector<QPointF> &points, double t) {
+    double pos = t * double(points.size() - 1);
+    size_t idx = std::min(size_t(pos), points.size() - 1);
+    if (idx + 1 == points.size())
+        return points[idx];
+
+    double frac = pos - double(idx);
+    return points[idx] * (1.0 - frac) + points[idx + 1] * frac;
+}
+
+// Takes positions of the nodes drawn previously from the seed layout. Nodes
+// not present there are placed next to their already placed neighbours,
+// whole components without any seeded node are placed randomly. Returns the
+// number of OGDF nodes positioned from the seed layout.
+static int seedNodePositions(ogdf::GraphAttributes &GA,
+                             const OGDFGraphLayout &layout, const GraphLayout &seedLayout,
+                             ogdf::NodeArray<bool> &seeded) {
+    const ogdf::Graph &G = GA.constGraph();
+    ogdf::NodeArray<bool> placed(G, false);
+    std::deque<ogdf::node> queue;
+    int seededCount = 0;
+
+    for (const auto &entry : layout) {
+        const DeBruijnNode *node = entry.first;
+        const auto &segments = entry.second;
+
+        bool reversed = false;
+        if (!seedLayout.contains(node)) {
+            node = node->getReverseComplement();
+            reversed = true;
+        }
+        if (!seedLayout.contains(node))
+            continue;
+
+        const auto &points = seedLayout.segments(node);
+        if (points.empty())
+            continue;
+
+        for (size_t i = 0; i < segments.size(); ++i) {
+            double t = segments.size() > 1 ? double(i) / double(segments.size() - 1) : 0.5;
+            QPointF point = interpolateSegments(points, reversed ? 1.0 - t : t);
+            ogdf::node v = segments[i];
+            GA.x(v) = point.x();
+            GA.y(v) = point.y();
+            seeded[v] = placed[v] = true;
+            queue.push_back(v);
+            seededCount += 1;
+        }
+    }
+
+    if (seededCount == 0)
+        return 0;
+
+    std::minstd_rand rng(clock());
+    std::uniform_real_distribution<double> jitter(-g_settings->edgeLength, g_settings->edgeLength);
+    while (!queue.empty()) {
+        ogdf::node v = queue.front();
+        queue.pop_front();
+
+        for (ogdf::adjEntry adj : v->adjEntries) {
+            ogdf::node w = adj->twinNode();
+            if (placed[w])
+                continue;
+
+            GA.x(w) = GA.x(v) + jitter(rng);
+            GA.y(w) = GA.y(v) + jitter(rng);
+            placed[w] = true;
+            queue.push_back(w);
+        }
+    }
+
+    double extent = std::sqrt(double(G.numberOfNodes())) * g_settings->edgeLength;
+    std::uniform_real_distribution<double> random(0, extent);
+    for (ogdf::node v : G.nodes) {
+        if (placed[v])
+            continue;
+        GA.x(v) = random(rng);
+        GA.y(v) = random(rng);
+    }
+
+    return seededCount;
+}
+
+void GraphLayoutWorker::setSeedLayout(GraphLayout seedLayout) {
+    m_seedLayout = std::make_unique<GraphLayout>(std::move(seedLayout));
+}
+
+std::unique_ptr<GraphLayouter> GraphLayoutWorker::makeLayouter() const {
+    std::unique_ptr<GraphLayouter> layouter;
+    switch (m_graphLayoutAlgorithm) {
+        case FAST_MULTIPOLE_LAYOUT:
+            layouter = std::make_unique<FastMultipoleGraphLayout>(m_graphLayoutQuality,
+                                                                  m_useLinearLayout,
+                                                                  m_graphLayoutComponentSeparation,
+                                                                  m_aspectRatio);
+            break;
+        case FMMM_LAYOUT:
+        default:
+            layouter = std::make_unique<FMMGraphLayout>(m_graphLayoutQuality,
+                                                        m_useLinearLayout,
+                                                        m_graphLayoutComponentSeparation,
+                                                        m_aspectRatio);
+            break;
+    }
+
+    layouter->setIncremental(m_incremental);
+    layouter->init();
+    return layouter;
+}
+
 GraphLayout GraphLayoutWorker::layoutGraph(const AssemblyGraph &graph) {
     ogdf::Graph G;
     ogdf::EdgeArray<double> edgeLengths(G);
@@ -539,6 +773,16 @@ GraphLayout GraphLayoutWorker::layoutGraph(const AssemblyGraph &graph) {
     OGDFGraphLayout layout(graph);
     buildGraph(G, GA, edgeLengths, layout, m_useLinearLayout);
 
+    // Reuse positions of the previously drawn nodes, if any
+    ogdf::NodeArray<bool> seeded(G, false);
+    ogdf::NodeArray<ogdf::DPoint> seedPositions(G);
+    m_incremental = false;
+    if (m_seedLayout && !m_useLinearLayout) {
+        m_incremental = seedNodePositions(GA, layout, *m_seedLayout, seeded) > 0;
+        for (ogdf::node v : G.nodes)
+            seedPositions[v] = GA.point(v);
+    }
+
     //first we split the graph into its components
     ogdf::NodeArray<int> componentNumber(G);
     int numberOfComponents = connectedComponents(G, componentNumber);
@@ -546,58 +790,133 @@ GraphLayout GraphLayoutWorker::layoutGraph(const AssemblyGraph &graph) {
         return GraphLayout(graph);
 
     ogdf::Array<ogdf::List<ogdf::node> > nodesInCC(numberOfComponents);
-    for (auto v : G.nodes)
+    ogdf::NodeArray<int> indexInCC(G);
+    for (auto v : G.nodes) {
+        indexInCC[v] = nodesInCC[componentNumber[v]].size();
         nodesInCC[componentNumber[v]].pushBack(v);
-
-    for (size_t i= 0; i < numberOfComponents; ++i) {
-        m_state.emplace_back(new FMMGraphLayout(m_graphLayoutQuality,
-                                               m_useLinearLayout,
-                                               m_graphLayoutComponentSeparation,
-                                               m_aspectRatio));
-        m_state.back()->init();
     }
 
-    for (int i = 0; i < numberOfComponents; i++) {
-        m_taskSynchronizer.addFuture(
-                QtConcurrent::run([&](GraphLayouter *layout,
-                        const ogdf::List<ogdf::node> &nodesInCC) {
-
-                    ogdf::GraphCopy GC;
-                    ogdf::EdgeArray<double> cedgeLengths(GC);
-                    ogdf::EdgeArray<ogdf::edge> auxCopy(G);
-
-                    GC.createEmpty(G);
-
-                    GC.initByNodes(nodesInCC, auxCopy);
-                    ogdf::GraphAttributes cGA(GC, GA.attributes());
-                    for (ogdf::node v : GC.nodes) {
-                        cGA.x(v) = GA.x(GC.original(v));
-                        cGA.y(v) = GA.y(GC.original(v));
-                        cGA.width(v) = GA.width(GC.original(v));
-                        cGA.height(v) = GA.height(GC.original(v));
-                    }
+    // Schedule the largest components first, so the long-running ones do not
+    // end up on the critical path. Small components are batched together into
+    // a single task to amortize the task overhead. Idle pool threads pick up
+    // the next task as soon as they are finished with the previous one.
+    std::vector<int> componentOrder(numberOfComponents);
+    std::iota(componentOrder.begin(), componentOrder.end(), 0);
+    std::stable_sort(componentOrder.begin(), componentOrder.end(),
+                     [&](int a, int b) { return nodesInCC[a].size() > nodesInCC[b].size(); });
+
+    std::vector<std::vector<int>> tasks;
+    int batchSize = 0;
+    for (int component : componentOrder) {
+        int componentSize = nodesInCC[component].size();
+        if (componentSize >= SmallComponentSize || tasks.empty() ||
+            batchSize + componentSize > ComponentBatchSize) {
+            tasks.emplace_back();
+            batchSize = 0;
+        }
 
-                    for (ogdf::edge e : GC.edges)
-                        cedgeLengths(e) = edgeLengths(GC.original(e));
+        tasks.back().push_back(component);
+        batchSize += componentSize;
+    }
 
-                    layout->run(cGA, cedgeLengths);
+    {
+        QMutexLocker locker(&m_stateMutex);
+        m_state.clear();
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            m_state.emplace_back(makeLayouter());
+            if (m_cancelled)
+                m_state.back()->cancel();
+        }
+    }
 
-                    for (ogdf::node v : GC.nodes) {
-                        ogdf::node w = GC.original(v);
-                        if (w == nullptr)
-                            continue;
+    // Progress is reported in percents of the OGDF nodes laid out
+    int totalNodes = G.numberOfNodes();
+    std::atomic<int> completedNodes = 0, reportedProgress = 0;
+    emit layoutProgress(0);
 
-                        GA.x(w) = cGA.x(v);
-                        GA.y(w) = cGA.y(v);
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        m_taskSynchronizer.addFuture(
+                QtConcurrent::run([&](GraphLayouter *layouter,
+                                      const std::vector<int> &components) {
+                    for (int component : components) {
+                        layoutComponent(*layouter, GA, edgeLengths, nodesInCC[component], indexInCC);
+
+                        int completed = (completedNodes += nodesInCC[component].size());
+                        int progress = int(100.0 * completed / totalNodes);
+                        int reported = reportedProgress;
+                        while (progress > reported) {
+                            if (reportedProgress.compare_exchange_weak(reported, progress)) {
+                                emit layoutProgress(progress);
+                                break;
+                            }
+                        }
                     }
-
-                }, m_state[i].get(), nodesInCC[i]));
+                }, m_state[i].get(), std::cref(tasks[i])));
     }
     m_taskSynchronizer.waitForFinished();
+    m_taskSynchronizer.clearFutures();
+
+    if (m_incremental) {
+        // Layouters are free to translate the components. Move each of them
+        // back, so the seeded nodes stay close to where they were drawn.
+        std::vector<int> unseededComponents;
+        double seededMaxX = std::numeric_limits<double>::lowest(), seededMinY = std::numeric_limits<double>::max();
+        for (int i = 0; i < numberOfComponents; ++i) {
+            ogdf::DPoint shift;
+            int seededCount = 0;
+            for (ogdf::node v : nodesInCC[i]) {
+                if (!seeded[v])
+                    continue;
+                shift += seedPositions[v] - GA.point(v);
+                seededCount += 1;
+            }
 
-    reassembleDrawings(GA,
-                       m_graphLayoutComponentSeparation, m_aspectRatio,
-                       nodesInCC);
+            if (seededCount == 0) {
+                unseededComponents.push_back(i);
+                continue;
+            }
+
+            shift = shift / seededCount;
+            for (ogdf::node v : nodesInCC[i]) {
+                GA.x(v) += shift.m_x;
+                GA.y(v) += shift.m_y;
+                seededMaxX = std::max(seededMaxX, GA.x(v) + GA.width(v) / 2);
+                seededMinY = std::min(seededMinY, GA.y(v) - GA.height(v) / 2);
+            }
+        }
+
+        // Only components that were not drawn before are packed (without
+        // rotation) and placed to the right of the seeded ones, which are
+        // left where they are.
+        if (!unseededComponents.empty()) {
+            ogdf::Array<ogdf::List<ogdf::node>> unseededCC(int(unseededComponents.size()));
+            for (size_t i = 0; i < unseededComponents.size(); ++i)
+                unseededCC[int(i)] = nodesInCC[unseededComponents[i]];
+            reassembleDrawings(GA,
+                               m_graphLayoutComponentSeparation, m_aspectRatio,
+                               unseededCC, false);
+
+            double minX = std::numeric_limits<double>::max(), minY = std::numeric_limits<double>::max();
+            for (const auto &component : unseededCC) {
+                for (ogdf::node v : component) {
+                    minX = std::min(minX, GA.x(v) - GA.width(v) / 2);
+                    minY = std::min(minY, GA.y(v) - GA.height(v) / 2);
+                }
+            }
+
+            double shiftX = seededMaxX + m_graphLayoutComponentSeparation - minX, shiftY = seededMinY - minY;
+            for (const auto &component : unseededCC) {
+                for (ogdf::node v : component) {
+                    GA.x(v) += shiftX;
+                    GA.y(v) += shiftY;
+                }
+            }
+        }
+    } else {
+        reassembleDrawings(GA,
+                           m_graphLayoutComponentSeparation, m_aspectRatio,
+                           nodesInCC);
+    }
 
     GraphLayout res(graph);
     for (const auto & entry : layout) {
@@ -617,9 +936,11 @@ GraphLayout GraphLayoutWorker::layoutGraph(const AssemblyGraph &graph) {
     return res;
 }
 
+// Cancelled layouters finish the remaining components without iterations, so
+// every component still gets a position (the current, incomplete layout)
 [[maybe_unused]] void GraphLayoutWorker::cancelLayout() {
+    QMutexLocker locker(&m_stateMutex);
+    m_cancelled = true;
     for (auto &layouter : m_state)
         layouter->cancel();
-    for (auto & future : m_taskSynchronizer.futures())
-        future.cancel();
 }
@@ -21,6 +21,10 @@
 
 #include <QObject>
 #include <QFutureSynchronizer>
+#include <QMutex>
+
+#include <memory>
+#include <vector>
 
 namespace ogdf {
     class Graph;
@@ -29,6 +33,7 @@ namespace ogdf {
 }
 
 class AssemblyGraph;
+enum GraphLayoutAlgorithm : int;
 
 class GraphLayouter {
 public:
@@ -41,7 +46,12 @@ public:
     virtual void cancel() = 0;
     virtual void run(ogdf::GraphAttributes &GA, const ogdf::EdgeArray<double> &edges) = 0;
 
+    // Refine the given node positions using a reduced iteration budget
+    // instead of laying out from scratch. Must be set before init().
+    void setIncremental(bool incremental) { m_incremental = incremental; }
+
 protected:
+    bool m_incremental = false;
     int m_graphLayoutQuality;
     bool m_useLinearLayout;
     double m_graphLayoutComponentSeparation;
@@ -52,7 +62,8 @@ class GraphLayoutWorker : public QObject {
     Q_OBJECT
 
 public:
-    GraphLayoutWorker(int graphLayoutQuality,
+    GraphLayoutWorker(GraphLayoutAlgorithm graphLayoutAlgorithm,
+                      int graphLayoutQuality,
                       bool useLinearLayout,
                       double graphLayoutComponentSeparation,
                       double aspectRatio = 1.333333);
@@ -60,9 +71,25 @@ public:
 
     GraphLayout layoutGraph(const AssemblyGraph &graph);
 
+    // Nodes present in the seed layout keep their positions, newly drawn nodes
+    // are placed next to their neighbours and the layout is only refined
+    void setSeedLayout(GraphLayout seedLayout);
+
+    // Components smaller than this (in OGDF nodes) are batched together into
+    // tasks of up to ComponentBatchSize nodes
+    static constexpr int SmallComponentSize = 1000;
+    static constexpr int ComponentBatchSize = 20000;
+
 private:
+    std::unique_ptr<GraphLayouter> makeLayouter() const;
+
     QFutureSynchronizer<void> m_taskSynchronizer;
+    QMutex m_stateMutex;
     std::vector<std::unique_ptr<GraphLayouter>> m_state;
+    std::unique_ptr<GraphLayout> m_seedLayout;
+    bool m_incremental = false;
+    bool m_cancelled = false;
+    GraphLayoutAlgorithm m_graphLayoutAlgorithm;
     int m_graphLayoutQuality;
     bool m_useLinearLayout;
     double m_graphLayoutComponentSeparation;
@@ -70,4 +97,8 @@ private:
 
 public slots:
     [[maybe_unused]] void cancelLayout();
+
+signals:
+    // Percentage of the graph laid out so far
+    void layoutProgress(int percent);
 };
\ No newline at end of file
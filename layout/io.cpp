@@ -22,11 +22,182 @@
 #include "graphlayout.h"
 
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
 
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
 namespace layout::io {
+    static constexpr char BinaryMagic[8] = { 'B', 'N', 'D', 'L', 'A', 'Y', 'T', '\0' };
+    static constexpr uint32_t BinaryVersion = 1;
+    // Written in native byte order, used to detect files from foreign-endian machines
+    static constexpr uint32_t BinaryByteOrderMark = 0x01020304;
+
+    struct BinaryHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrderMark;
+        uint64_t nodeCount;
+        uint64_t pointCount;
+    };
+
+    bool isBinary(const QString &filename) {
+        return QFileInfo(filename).suffix().compare("blayout", Qt::CaseInsensitive) == 0;
+    }
+
+    template<class T>
+    static bool writeRaw(QFile &file, const T &value) {
+        return file.write(reinterpret_cast<const char*>(&value), sizeof(T)) == qint64(sizeof(T));
+    }
+
+    bool saveBinary(const QString &filename,
+                    const GraphLayout &layout) {
+        QFile saveFile(filename);
+        if (!saveFile.open(QIODevice::WriteOnly))
+            return false;
+
+        BinaryHeader header;
+        std::memcpy(header.magic, BinaryMagic, sizeof(BinaryMagic));
+        header.version = BinaryVersion;
+        header.byteOrderMark = BinaryByteOrderMark;
+        header.nodeCount = layout.size();
+        header.pointCount = 0;
+        for (const auto &entry: layout)
+            header.pointCount += entry.second.size();
+        if (!writeRaw(saveFile, header))
+            return false;
+
+        // Node name table
+        for (const auto &entry: layout) {
+            std::string name = entry.first->getStdName();
+            if (!writeRaw(saveFile, uint32_t(name.size())) ||
+                saveFile.write(name.data(), qint64(name.size())) != qint64(name.size()))
+                return false;
+        }
+
+        // Number of points for each node (in the name table order)
+        for (const auto &entry: layout) {
+            if (!writeRaw(saveFile, uint32_t(entry.second.size())))
+                return false;
+        }
+
+        // Point coordinates
+        for (const auto &entry: layout) {
+            for (QPointF point: entry.second) {
+                if (!writeRaw(saveFile, float(point.x())) ||
+                    !writeRaw(saveFile, float(point.y())))
+                    return false;
+            }
+        }
+
+        // Buffered data may only fail to be written at flush time (e.g. disk full)
+        if (!saveFile.flush())
+            return false;
+        saveFile.close();
+        return saveFile.error() == QFileDevice::NoError;
+    }
+
+    namespace {
+        class BinaryReader {
+          public:
+            BinaryReader(const uchar *data, size_t size)
+                    : m_pos(data), m_end(data + size) {}
+
+            template<class T>
+            T read() {
+                T value;
+                std::memcpy(&value, advance(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            std::string_view readString(size_t size) {
+                return { reinterpret_cast<const char*>(advance(size)), size };
+            }
+
+            size_t remaining() const { return size_t(m_end - m_pos); }
+
+          private:
+            const uchar *advance(size_t size) {
+                if (size_t(m_end - m_pos) < size)
+                    throw std::runtime_error("invalid layout format: unexpected end of file");
+                const uchar *res = m_pos;
+                m_pos += size;
+                return res;
+            }
+
+            const uchar *m_pos;
+            const uchar *m_end;
+        };
+    }
+
+    bool loadBinary(const QString &filename,
+                    GraphLayout &layout) {
+        QFile loadFile(filename);
+        if (!loadFile.open(QIODevice::ReadOnly))
+            throw std::runtime_error("cannot open file: " + filename.toStdString());
+
+        // Prefer mapping the file, fall back to reading it if this is not possible
+        QByteArray contents;
+        const uchar *data = loadFile.map(0, loadFile.size());
+        if (!data) {
+            contents = loadFile.readAll();
+            data = reinterpret_cast<const uchar*>(contents.constData());
+        }
+        BinaryReader reader(data, size_t(loadFile.size()));
+
+        auto header = reader.read<BinaryHeader>();
+        if (std::memcmp(header.magic, BinaryMagic, sizeof(BinaryMagic)) != 0)
+            throw std::runtime_error("invalid layout format");
+        if (header.byteOrderMark != BinaryByteOrderMark)
+            throw std::runtime_error("invalid layout format: unsupported byte order");
+        if (header.version != BinaryVersion)
+            throw std::runtime_error("unsupported layout format version: " + std::to_string(header.version));
+
+        // Every node needs at least its name length and point count, every point two
+        // coordinates. Check before reserving anything as the header is not trusted.
+        constexpr size_t MinNodeSize = 2 * sizeof(uint32_t), PointSize = 2 * sizeof(float);
+        if (header.nodeCount > reader.remaining() / MinNodeSize ||
+            header.pointCount > reader.remaining() / PointSize)
+            throw std::runtime_error("invalid layout format: header counts exceed file size");
+
+        const AssemblyGraph &graph = layout.graph();
+        std::vector<DeBruijnNode*> nodes;
+        nodes.reserve(header.nodeCount);
+        for (uint64_t i = 0; i < header.nodeCount; ++i) {
+            auto name = reader.readString(reader.read<uint32_t>());
+            auto node = graph.m_deBruijnGraphNodes.find(name);
+            if (node == graph.m_deBruijnGraphNodes.end())
+                throw std::runtime_error("graph does not contain node: " + std::string(name));
+            nodes.push_back(*node);
+        }
+
+        std::vector<uint32_t> pointCounts;
+        pointCounts.reserve(header.nodeCount);
+        uint64_t totalPoints = 0;
+        for (uint64_t i = 0; i < header.nodeCount; ++i) {
+            pointCounts.push_back(reader.read<uint32_t>());
+            totalPoints += pointCounts.back();
+        }
+        if (totalPoints != header.pointCount ||
+            totalPoints > reader.remaining() / PointSize)
+            throw std::runtime_error("invalid layout format: point counts do not match file size");
+
+        for (uint64_t i = 0; i < header.nodeCount; ++i) {
+            auto &segments = layout.segments(nodes[i]);
+            for (uint32_t j = 0; j < pointCounts[i]; ++j) {
+                float x = reader.read<float>();
+                float y = reader.read<float>();
+                segments.emplace_back(x, y);
+            }
+        }
+
+        return true;
+    }
+
     bool save(const QString &filename,
               const GraphLayout &layout) {
         QJsonObject jsonLayout;
@@ -65,6 +236,9 @@ namespace layout::io {
 
     bool load(const QString &filename,
               GraphLayout &layout) {
+        if (isBinary(filename))
+            return loadBinary(filename, layout);
+
         QFile loadFile(filename);
         // FIXME: Switch to Error return object stuff!
         if (!loadFile.open(QIODevice::ReadOnly | QIODevice::Text))
@@ -18,10 +18,20 @@
 #include "graphlayout.h"
 
 namespace layout::io {
+    // Loads either JSON or binary layout, depending on the file extension
     bool load(const QString &filename,
               GraphLayout &layout);
     bool save(const QString &filename,
               const GraphLayout &layout);
     bool saveTSV(const QString &filename,
                  const GraphLayout &layout);
+
+    // Compact binary layout: header, node name table, per-node point counts
+    // and float32 point coordinates. Written in a streaming fashion and
+    // read from a memory-mapped file.
+    bool isBinary(const QString &filename);
+    bool loadBinary(const QString &filename,
+                    GraphLayout &layout);
+    bool saveBinary(const QString &filename,
+                    const GraphLayout &layout);
 };
\ No newline at end of file
@@ -27,6 +27,7 @@ double g_absoluteZoom;
 QSharedPointer<search::BlastSearch> g_blastSearch;
 QSharedPointer<AssemblyGraph> g_assemblyGraph;
 std::shared_ptr<AnnotationsManager> g_annotationsManager;
+size_t g_outlineStrokeCount = 0;
 
 
 QString formatIntForDisplay(int num) {
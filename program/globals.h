@@ -22,6 +22,7 @@
 #include <QString>
 #include <QSharedPointer>
 
+#include <cstddef>
 #include <utility>
 
 class Settings;
@@ -45,6 +46,10 @@ extern QSharedPointer<search::BlastSearch> g_blastSearch;
 extern QSharedPointer<AssemblyGraph> g_assemblyGraph;
 extern std::shared_ptr<AnnotationsManager> g_annotationsManager;
 
+// Number of QPainterPathStroker invocations made by graphics items. The view
+// reports and resets it on each frame when paint profiling is enabled.
+extern size_t g_outlineStrokeCount;
+
 
 //Functions for formatting numbers are used in many places, and are made global.
 QString formatIntForDisplay(int num);
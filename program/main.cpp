@@ -34,6 +34,7 @@
 #include "command_line/image.h"
 #include "command_line/querypaths.h"
 #include "command_line/reduce.h"
+#include "command_line/compact.h"
 #include "command_line/settings.h"
 #include "command_line/commoncommandlinefunctions.h"
 #include <CLI/CLI.hpp>
@@ -56,6 +57,7 @@ using SubCmd = std::variant<std::monostate,
                             ImageCmd,
                             InfoCmd,
                             ReduceCmd,
+                            CompactCmd,
                             QueryPathsCmd,
                             LayoutCmd>;
 
@@ -87,6 +89,10 @@ static SubCmd parseCmdLine(CLI::App &app, int argc, char *argv[]) {
     ReduceCmd reduceCmd;
     auto *reduce = addReduceSubcommand(app, reduceCmd);
 
+    // "BandageNG compact"
+    CompactCmd compactCmd;
+    auto *compact = addCompactSubcommand(app, compactCmd);
+
     // "BandageNG querypaths"
     QueryPathsCmd qpCmd;
     auto *qp = addQueryPathsSubcommand(app, qpCmd);
@@ -111,6 +117,8 @@ static SubCmd parseCmdLine(CLI::App &app, int argc, char *argv[]) {
     } else if (app.got_subcommand(reduce)) {
         g_memory->commandLineCommand = BANDAGE_REDUCE; // FIXME: not needed
         subcmd = reduceCmd;
+    } else if (app.got_subcommand(compact)) {
+        subcmd = compactCmd;
     } else if (app.got_subcommand(qp)) {
         g_memory->commandLineCommand = BANDAGE_QUERY_PATHS; // FIXME: not needed
         subcmd = qpCmd;
@@ -185,6 +193,8 @@ int main(int argc, char *argv[]) {
             return handleInfoCmd(app.get(), cli, command);
         } else  if constexpr (std::is_same_v<T, ReduceCmd>) {
             return handleReduceCmd(app.get(), cli, command);
+        } else  if constexpr (std::is_same_v<T, CompactCmd>) {
+            return handleCompactCmd(app.get(), cli, command);
         } else  if constexpr (std::is_same_v<T, QueryPathsCmd>) {
             return handleQueryPathsCmd(app.get(), cli, command);
         } else  if constexpr (std::is_same_v<T, LayoutCmd>) {
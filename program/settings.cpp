@@ -30,6 +30,8 @@ Settings::Settings()
     meanNodeLength = 40.0;
     minTotalGraphLength = 500.0;
     graphLayoutQuality = IntSetting(2, 0, 4);
+    graphLayoutAlgorithm = FMMM_LAYOUT;
+    incrementalLayout = true;
     linearLayout = false;
     minimumNodeLength = FloatSetting(5.0, 1.0, 100.0);
     edgeLength = FloatSetting(5.0, 0.1, 100.0);
@@ -42,6 +44,10 @@ Settings::Settings()
     depthPower = FloatSetting(0.5, 0.0, 1.0);
 
     jumpsAsLinks = false;
+    loaderThreads = IntSetting(0, 0, 256);
+    twoPassLoading = false;
+    gafMinMapQ = IntSetting(0, 0, 255);
+    gafMinAlignmentLength = IntSetting(0, 0, 1000000000);
     edgeWidth = FloatSetting(1.5, 0.1, 100);
     linkWidth = FloatSetting(0.5, 0.1, 100);
     outlineThickness = FloatSetting(0.0, 0.0, 100.0);
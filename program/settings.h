@@ -85,6 +85,7 @@ using AnnotationSettings = std::unordered_map<AnnotationGroupId, AnnotationSetti
 
 enum NodeLengthMode {AUTO_NODE_LENGTH, MANUAL_NODE_LENGTH};
 enum NodeDragging {ONE_PIECE, NEARBY_PIECES, ALL_PIECES, NO_DRAGGING};
+enum GraphLayoutAlgorithm : int {FMMM_LAYOUT, FAST_MULTIPOLE_LAYOUT};
 
 class Settings
 {
@@ -99,7 +100,9 @@ public:
     double meanNodeLength;
     double minTotalGraphLength;
     IntSetting graphLayoutQuality;
+    GraphLayoutAlgorithm graphLayoutAlgorithm;
     bool linearLayout;
+    bool incrementalLayout;
     FloatSetting minimumNodeLength;
     FloatSetting edgeLength;
     FloatSetting doubleModeNodeSeparation;
@@ -111,6 +114,10 @@ public:
     FloatSetting depthPower;
 
     bool jumpsAsLinks;
+    IntSetting loaderThreads; // 0 = use all available cores
+    bool twoPassLoading;
+    IntSetting gafMinMapQ;
+    IntSetting gafMinAlignmentLength;
     FloatSetting edgeWidth;
     FloatSetting linkWidth;
     FloatSetting outlineThickness;
@@ -147,15 +147,25 @@ test_all "$bandagepath image inputs/test.fastg tmp/test.png  --width 400 --heigh
 test_image_width_and_height tmp/test.png 400 500; rm tmp/test.png
 test_all "$bandagepath image inputs/test.fastg tmp/test.png  --width 500 --height 400" 0 "" ""
 test_image_width_and_height tmp/test.png 500 400; rm tmp/test.png
+test_all "$bandagepath image inputs/test.fastg tmp/test.dzi --width 1000" 0 "" ""
+test_image_width tmp/test_files/10/0_0.png 256; rm -r tmp/test.dzi tmp/test_files
 test_all "$bandagepath image abc.fastg test.png" 105 "" "<graph>: File does not exist: abc.fastg Run with --help or --helpall for more information."
-test_all "$bandagepath image inputs/test.fastg test.abc" 1 "" "Bandage-NG error: the output filename must end in .png, .jpg or .svg"
+test_all "$bandagepath image inputs/test.fastg test.abc" 1 "" "Bandage-NG error: the output filename must end in .png, .jpg, .svg or .dzi"
 test_all "$bandagepath image inputs/test.csv tmp/test.png" 1 "" "Bandage-NG error: could not load inputs/test.csv"
 test_all "$bandagepath image inputs/test.fastg test.png --query abc.fasta" 105 "" "--query: File does not exist: abc.fasta Run with --help or --helpall for more information."
 test_all "$bandagepath image inputs/test_rgfa.gfa test.png --colour gfa" 0 "" ""
 test_all "$bandagepath image inputs/test.gfa test.png --colour gc" 0 "" ""
+test_all "$bandagepath image inputs/test.gfa tmp/test.png --bed inputs/test.bed" 0 "" ""; rm tmp/test.png
+test_all "$bandagepath image inputs/test.gfa tmp/test.png --bed inputs/test.bed.gz" 0 "" ""; rm tmp/test.png
+test_all "$bandagepath image inputs/test.gfa tmp/test.png --bed abc.bed" 105 "" "--bed: File does not exist: abc.bed Run with --help or --helpall for more information."
 
 # BandageNG info tests
-test_all "$bandagepath info inputs/test.gfa --tsv" 0 "inputs/test.gfa 17 16 60 60 30959 29939 10 29.4118% 1 30959 0 2060 119 2001 2060 2060 2060 532.042 25939" ""
+test_all "$bandagepath info inputs/test.gfa --tsv" 0 "inputs/test.gfa 17 16 60 60 30959 29939 10 29.4118% 1 30959 0 2060 119 2001 2060 2060 2060 532.042 25939 17:1" ""
+
+# BandageNG compact tests
+test_all "$bandagepath compact abc.fastg test.gfa" 105 "" "<inputgraph>: File does not exist: abc.fastg Run with --help or --helpall for more information."
+test_all "$bandagepath compact inputs/test.gfa tmp/test_compact.gfa" 0 "Merged 0 non-branching paths" ""; rm tmp/test_compact.gfa
+test_all "$bandagepath compact inputs/test_compact.gfa tmp/test_compact.gfa" 0 "Merged 1 non-branching paths" ""; rm tmp/test_compact.gfa
 
 # BandageNG load tests
 test_all "$bandagepath load abc.fastg" 105 "" "<graph>: File does not exist: abc.fastg Run with --help or --helpall for more information."
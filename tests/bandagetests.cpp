@@ -23,7 +23,9 @@
 #include "graph/graphicsitemnode.h"
 #include "graph/annotationsmanager.h"
 #include "graph/gfawriter.h"
+#include "graph/graphstats.h"
 #include "graph/io.h"
+#include "graph/sequenceutils.h"
 
 #include "layout/graphlayoutworker.h"
 #include "layout/io.h"
@@ -32,6 +34,7 @@
 #include "program/memory.h"
 #include "program/globals.h"
 #include "command_line/commoncommandlinefunctions.h"
+#include "command_line/compact.h"
 #include "command_line/settings.h"
 
 #include "graphsearch/blast/blastsearch.h"
@@ -42,6 +45,7 @@
 #include <QDebug>
 #include <QTemporaryDir>
 
+#include <cstring>
 #include <iostream>
 
 class BandageTests : public QObject
@@ -104,6 +108,8 @@ private slots:
     void loadGFAWithPlaceholders();
     void loadGFA12();
     void loadGFA();
+    void loadGFAMultithreaded();
+    void loadGFATwoPass();
     void loadGAF();
     void loadSPAdesPaths();
     void loadLinks();
@@ -117,22 +123,30 @@ private slots:
     void loadCsvDataTrinity();
     void blastSearch();
     void blastSearchFilters();
+    void annotationStore();
+    void loadBED();
     void graphScope();
     void graphLayout();
+    void incrementalLayoutNewComponents();
     void commandLineSettings();
     void sciNotComparisons();
     void graphEdits();
     void fastgToGfa();
     void mergeNodesOnGfa();
+    void compactGraph();
     void changeNodeNames();
     void changeNodeDepths();
     void blastQueryPaths();
+    void allPossiblePaths();
     void bandageInfo();
+    void nodeMetrics();
     void sequenceInit();
     void sequenceInitN();
+    void sequenceMissing();
     void sequenceAccess();
     void sequenceSubstring();
     void sequenceDoubleReverseComplement();
+    void sequenceKernels();
 
 
 private:
@@ -212,6 +226,39 @@ void BandageTests::loadGFA()
     QCOMPARE(node14->getLength(), 120);
 }
 
+void BandageTests::loadGFAMultithreaded()
+{
+    // Single-threaded and multi-threaded parsing should produce the same graph
+    g_settings->loaderThreads = 1;
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_gfa12.gfa.gz")));
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes.size(), 12);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphEdges.size(), 16);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphPaths.size(), 5);
+
+    g_settings->loaderThreads = 4;
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_gfa12.gfa.gz")));
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes.size(), 12);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphEdges.size(), 16);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphPaths.size(), 5);
+    QVERIFY(g_assemblyGraph->m_loadThroughput > 0);
+}
+
+void BandageTests::loadGFATwoPass()
+{
+    g_settings->twoPassLoading = true;
+
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_gfa12.gfa.gz")));
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes.size(), 12);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphEdges.size(), 16);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphPaths.size(), 5);
+
+    // Links to undefined segments still produce placeholders
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_not_defined.gfa")));
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes.size(), 8);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphEdges.size(), 8);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes["4-"]->getLength(), 0);
+}
+
 void BandageTests::loadGAF()
 {
     // Check that the graph loaded properly.
@@ -227,8 +274,20 @@ void BandageTests::loadGAF()
     QCOMPARE(node1->getLength(), 44);
     QCOMPARE(node14->getLength(), 42);
 
-    QVERIFY(io::loadGAFPaths(*g_assemblyGraph, testFile("test.gaf")));
-    const Path &p = g_assemblyGraph->m_deBruijnGraphPaths["read"];
+    // The only alignment has mapq 60
+    io::GAFFilter filter;
+    filter.minMapQ = 61;
+    size_t skipped = 0;
+    QVERIFY(io::loadGAFPaths(*g_assemblyGraph, testFile("test.gaf"), filter, &skipped));
+    QCOMPARE(skipped, size_t(1));
+    QVERIFY(g_assemblyGraph->m_deBruijnGraphPaths.find("read") == g_assemblyGraph->m_deBruijnGraphPaths.end());
+
+    QVERIFY(io::loadGAFPaths(*g_assemblyGraph, testFile("test.gaf"), {}, &skipped));
+    QCOMPARE(skipped, size_t(0));
+    // Trimmed start / end must survive the round trip through the path store
+    auto readId = g_assemblyGraph->m_deBruijnGraphPaths["read"];
+    QCOMPARE(g_assemblyGraph->m_pathStore.length(readId), 71);
+    Path p = g_assemblyGraph->getPath(readId);
     QCOMPARE(p.getLength(), 71);
 }
 
@@ -248,13 +307,32 @@ void BandageTests::loadSPAdesPaths()
     QCOMPARE(node14->getLength(), 120);
 
     QVERIFY(io::loadSPAdesPaths(*g_assemblyGraph, testFile("test.paths")));
-    const Path &p1 = g_assemblyGraph->m_deBruijnGraphPaths["NODE_FIRST"];
+    Path p1 = g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["NODE_FIRST"]);
     QCOMPARE(p1.getLength(), 4060);
 
-    const Path &p21 = g_assemblyGraph->m_deBruijnGraphPaths["NODE_SECOND_1"];
+    Path p21 = g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["NODE_SECOND_1"]);
     QCOMPARE(p21.getLength(), 4000);
-    const Path &p22 = g_assemblyGraph->m_deBruijnGraphPaths["NODE_SECOND_2"];
+    Path p22 = g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["NODE_SECOND_2"]);
     QCOMPARE(p22.getLength(), 6000);
+
+    // Every node must be indexed with exactly the paths passing through it
+    const auto &index = g_assemblyGraph->m_pathIndex;
+    QCOMPARE(index.size(), g_assemblyGraph->m_deBruijnGraphPaths.size());
+    std::vector<Path> paths;
+    for (uint32_t id = 0; id < index.size(); ++id) {
+        paths.push_back(g_assemblyGraph->getPath(index.value(id)));
+        QCOMPARE(g_assemblyGraph->m_deBruijnGraphPaths.at(index.name(id)), index.value(id));
+    }
+    for (const auto *node : g_assemblyGraph->m_deBruijnGraphNodes) {
+        size_t pathCount = 0;
+        for (const auto &path : paths)
+            pathCount += path.containsNode(node);
+
+        auto pathIds = index.pathsThrough(node);
+        QCOMPARE(size_t(std::distance(pathIds.begin(), pathIds.end())), pathCount);
+        for (uint32_t id : pathIds)
+            QVERIFY(paths[id].containsNode(node));
+    }
 }
 
 void BandageTests::loadLinks()
@@ -691,6 +769,85 @@ void BandageTests::blastSearchFilters()
 
 
 
+void BandageTests::annotationStore()
+{
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.gfa")));
+    const DeBruijnNode *node1 = g_assemblyGraph->m_deBruijnGraphNodes["1+"];
+    const DeBruijnNode *node2 = g_assemblyGraph->m_deBruijnGraphNodes["2+"];
+
+    AnnotationStore store;
+    auto a = store.add(node1, 500, 900, qRgb(255, 0, 0), "a");
+    auto b = store.add(node1, 10, 1500, qRgb(0, 255, 0), "b");
+    auto c = store.add(node2, 0, 100, qRgb(0, 0, 255), "c");
+    auto d = store.add(node1, 100, 200, qRgb(0, 0, 0), "d");
+    store.setBlocks(d, { { 100, 120 }, { 180, 200 } });
+    store.buildIndex();
+
+    QCOMPARE(store.size(), size_t(4));
+    QVERIFY(store.name(b) == "b");
+    QCOMPARE(store.colour(c), qRgb(0, 0, 255));
+    QVERIFY(store.hasFeatures(node2));
+    QVERIFY(!store.hasFeatures(node2->getReverseComplement()));
+    QVERIFY(std::distance(store.blocks(d).begin(), store.blocks(d).end()) == 2);
+    QVERIFY(store.blocks(a).empty());
+    QVERIFY(!store.hasThick());
+    QCOMPARE(store.thickStart(a), int64_t(500));
+
+    // Features are sorted by start within the node
+    std::vector<AnnotationStore::FeatureId> features(store.features(node1).begin(), store.features(node1).end());
+    QVERIFY(features == std::vector<AnnotationStore::FeatureId>({ b, d, a }));
+
+    auto overlapping = [&](const DeBruijnNode *node, int64_t from, int64_t to) {
+        std::vector<AnnotationStore::FeatureId> res;
+        store.forEachOverlapping(node, from, to, [&](AnnotationStore::FeatureId id) { res.push_back(id); });
+        return res;
+    };
+    QVERIFY(overlapping(node1, 0, 5) == std::vector<AnnotationStore::FeatureId>());
+    QVERIFY(overlapping(node1, 300, 400) == std::vector<AnnotationStore::FeatureId>({ b }));
+    QVERIFY(overlapping(node1, 150, 600) == std::vector<AnnotationStore::FeatureId>({ b, d, a }));
+    QVERIFY(overlapping(node1, 1000, 2000) == std::vector<AnnotationStore::FeatureId>({ b }));
+    QVERIFY(overlapping(node2, 100, 100) == std::vector<AnnotationStore::FeatureId>({ c }));
+    QVERIFY(overlapping(node2, 101, 200) == std::vector<AnnotationStore::FeatureId>());
+}
+
+void BandageTests::loadBED()
+{
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.gfa")));
+    const DeBruijnNode *node1 = g_assemblyGraph->m_deBruijnGraphNodes["1+"];
+    DeBruijnNode *node14 = g_assemblyGraph->m_deBruijnGraphNodes["14+"];
+
+    // The feature on an unknown sequence is skipped
+    AnnotationStore annotations;
+    QVERIFY(io::loadBEDAnnotations(*g_assemblyGraph, testFile("test.bed"), annotations));
+    QCOMPARE(annotations.size(), size_t(4));
+    QVERIFY(annotations.hasFeatures(node1->getReverseComplement()));
+
+    auto features = annotations.features(node1);
+    QCOMPARE(std::distance(features.begin(), features.end()), std::ptrdiff_t(1));
+    auto id = *features.begin();
+    QVERIFY(annotations.name(id) == "a");
+    QCOMPARE(annotations.start(id), int64_t(0));
+    QCOMPARE(annotations.end(id), int64_t(100));
+    QCOMPARE(annotations.colour(id), qRgb(255, 0, 0));
+    QCOMPARE(annotations.thickStart(id), int64_t(10));
+    QCOMPARE(annotations.thickEnd(id), int64_t(90));
+    std::vector<std::pair<int64_t, int64_t>> blocks;
+    for (const auto &block : annotations.blocks(id))
+        blocks.emplace_back(block.start, block.end);
+    QVERIFY(blocks == std::vector<std::pair<int64_t, int64_t>>({ { 0, 10 }, { 80, 100 } }));
+
+    AnnotationStore compressed;
+    QVERIFY(io::loadBEDAnnotations(*g_assemblyGraph, testFile("test.bed.gz"), compressed));
+    QCOMPARE(compressed.size(), size_t(4));
+
+    // Only the features on drawn nodes are read using the tabix index
+    node14->setAsDrawn();
+    AnnotationStore drawn;
+    QVERIFY(io::loadBEDAnnotations(*g_assemblyGraph, testFile("test.bed.gz"), drawn, true));
+    QCOMPARE(drawn.size(), size_t(1));
+    QVERIFY(drawn.hasFeatures(node14));
+}
+
 void BandageTests::graphScope()
 {
     QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.fastg")));
@@ -872,6 +1029,38 @@ void BandageTests::graphScope()
     layout::apply(*g_assemblyGraph, layout);
     drawnNodes = g_assemblyGraph->getDrawnNodeCount();
     QCOMPARE(drawnNodes, 42);
+
+    // Binary layout round trip
+    QString binaryLayoutFile = tempFile("test.blayout");
+    QVERIFY(layout::io::isBinary(binaryLayoutFile));
+    QVERIFY(layout::io::saveBinary(binaryLayoutFile, layout));
+    GraphLayout binaryLayout(*g_assemblyGraph);
+    QVERIFY(layout::io::load(binaryLayoutFile, binaryLayout));
+    QCOMPARE(binaryLayout.size(), layout.size());
+    for (const auto &entry : layout) {
+        const auto &segments = binaryLayout.segments(entry.first);
+        QCOMPARE(segments.size(), entry.second.size());
+        for (size_t i = 0; i < segments.size(); ++i) {
+            QCOMPARE(segments[i].x(), double(float(entry.second[i].x())));
+            QCOMPARE(segments[i].y(), double(float(entry.second[i].y())));
+        }
+    }
+
+    // Node count in the header exceeding the file size must be rejected
+    {
+        QFile file(binaryLayoutFile);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QByteArray contents = file.readAll();
+        file.close();
+        uint64_t bogusCount = uint64_t(1) << 60;
+        std::memcpy(contents.data() + 16, &bogusCount, sizeof(bogusCount));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+        file.close();
+
+        GraphLayout corruptLayout(*g_assemblyGraph);
+        QVERIFY_THROWS_EXCEPTION(std::runtime_error, layout::io::load(binaryLayoutFile, corruptLayout));
+    }
 }
 
 
@@ -891,11 +1080,21 @@ void BandageTests::graphLayout() {
         g_assemblyGraph->markNodesToDraw(scope, startingNodes);
         QCOMPARE(g_assemblyGraph->getDrawnNodeCount(), 44);
 
-        auto layout = GraphLayoutWorker(g_settings->graphLayoutQuality,
+        auto layout = GraphLayoutWorker(g_settings->graphLayoutAlgorithm,
+                                        g_settings->graphLayoutQuality,
                                         g_settings->linearLayout,
                                         g_settings->componentSeparation).layoutGraph(*g_assemblyGraph);
 
         QCOMPARE(layout.size(), 44);
+
+        // Incremental layout starting from the previous one
+        GraphLayoutWorker incrementalWorker(g_settings->graphLayoutAlgorithm,
+                                            g_settings->graphLayoutQuality,
+                                            g_settings->linearLayout,
+                                            g_settings->componentSeparation);
+        incrementalWorker.setSeedLayout(layout);
+        auto incrementalLayout = incrementalWorker.layoutGraph(*g_assemblyGraph);
+        QCOMPARE(incrementalLayout.size(), 44);
     }
 
     {
@@ -908,7 +1107,17 @@ void BandageTests::graphLayout() {
         g_assemblyGraph->markNodesToDraw(scope, startingNodes);
         QCOMPARE(g_assemblyGraph->getDrawnNodeCount(), 88);
 
-        auto layout = GraphLayoutWorker(g_settings->graphLayoutQuality,
+        auto layout = GraphLayoutWorker(g_settings->graphLayoutAlgorithm,
+                                        g_settings->graphLayoutQuality,
+                                        g_settings->linearLayout,
+                                        g_settings->componentSeparation).layoutGraph(*g_assemblyGraph);
+
+        QCOMPARE(layout.size(), 88);
+    }
+
+    {
+        auto layout = GraphLayoutWorker(FAST_MULTIPOLE_LAYOUT,
+                                        g_settings->graphLayoutQuality,
                                         g_settings->linearLayout,
                                         g_settings->componentSeparation).layoutGraph(*g_assemblyGraph);
 
@@ -916,6 +1125,78 @@ void BandageTests::graphLayout() {
     }
 }
 
+void BandageTests::incrementalLayoutNewComponents() {
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.Trinity.fasta")));
+    g_settings->doubleMode = false;
+
+    QString errorTitle;
+    QString errorMessage;
+
+    // Draw a single component first
+    const DeBruijnNode *firstNode = *g_assemblyGraph->m_deBruijnGraphNodes.begin();
+    auto scope = graph::Scope::aroundNodes(firstNode->getNameWithoutSign(), 1000);
+    auto startingNodes = graph::getStartingNodes(&errorTitle, &errorMessage,
+                                                 *g_assemblyGraph, scope);
+    g_assemblyGraph->resetNodes();
+    g_assemblyGraph->markNodesToDraw(scope, startingNodes);
+    int seededNodes = g_assemblyGraph->getDrawnNodeCount();
+    QVERIFY(seededNodes > 0);
+
+    auto seedLayout = GraphLayoutWorker(g_settings->graphLayoutAlgorithm,
+                                        g_settings->graphLayoutQuality,
+                                        g_settings->linearLayout,
+                                        g_settings->componentSeparation).layoutGraph(*g_assemblyGraph);
+
+    // Now draw the whole graph, all other components are new
+    scope = graph::Scope::wholeGraph();
+    startingNodes = graph::getStartingNodes(&errorTitle, &errorMessage,
+                                            *g_assemblyGraph, scope);
+    g_assemblyGraph->resetNodes();
+    g_assemblyGraph->markNodesToDraw(scope, startingNodes);
+    QVERIFY(g_assemblyGraph->getDrawnNodeCount() > seededNodes);
+
+    GraphLayoutWorker incrementalWorker(g_settings->graphLayoutAlgorithm,
+                                        g_settings->graphLayoutQuality,
+                                        g_settings->linearLayout,
+                                        g_settings->componentSeparation);
+    incrementalWorker.setSeedLayout(seedLayout);
+    auto layout = incrementalWorker.layoutGraph(*g_assemblyGraph);
+    QCOMPARE(layout.size(), size_t(g_assemblyGraph->getDrawnNodeCount()));
+
+    // The seeded component is refined in place: its centre does not move
+    QPointF seedCentre, centre;
+    size_t points = 0;
+    double seededMaxX = std::numeric_limits<double>::lowest();
+    for (const auto &entry : seedLayout) {
+        // The other strand might be drawn now
+        const DeBruijnNode *node = entry.first;
+        if (!layout.contains(node))
+            node = node->getReverseComplement();
+        QVERIFY(layout.contains(node));
+        const auto &segments = layout.segments(node);
+        QCOMPARE(segments.size(), entry.second.size());
+        for (size_t i = 0; i < segments.size(); ++i) {
+            seedCentre += entry.second[i];
+            centre += segments[i];
+            seededMaxX = std::max(seededMaxX, segments[i].x());
+            points += 1;
+        }
+    }
+    seedCentre /= double(points);
+    centre /= double(points);
+    QVERIFY(std::abs(seedCentre.x() - centre.x()) < 1e-3);
+    QVERIFY(std::abs(seedCentre.y() - centre.y()) < 1e-3);
+
+    // New components are placed next to the seeded one
+    for (const auto &entry : layout) {
+        if (seedLayout.contains(entry.first) ||
+            seedLayout.contains(entry.first->getReverseComplement()))
+            continue;
+        for (const auto &point : entry.second)
+            QVERIFY(point.x() > seededMaxX);
+    }
+}
+
 static void parseSettings(const QStringList &commandLineSettings) {
     std::vector<std::string> strings;
     std::vector<const char*> argv;
@@ -995,6 +1276,10 @@ void BandageTests::commandLineSettings() {
     parseSettings(commandLineSettings);
     QCOMPARE(g_settings->graphLayoutQuality.val, 1);
 
+    commandLineSettings = QString("--layoutalgo fme").split(" ");
+    parseSettings(commandLineSettings);
+    QCOMPARE(g_settings->graphLayoutAlgorithm, FAST_MULTIPOLE_LAYOUT);
+
     commandLineSettings = QString("--nodewidth 4.2").split(" ");
     parseSettings(commandLineSettings);
     QCOMPARE(g_settings->averageNodeWidth.val, 4.2);
@@ -1451,6 +1736,37 @@ void BandageTests::mergeNodesOnGfa()
     QCOMPARE(doCircularSequencesMatch(path1Sequence, path2Sequence), true);
 }
 
+void BandageTests::compactGraph()
+{
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_compact.gfa")));
+    QByteArray path1Sequence = g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["p1"]).getPathSequence();
+
+    CompactCmd cmd;
+    cmd.m_graph = testFile("test_compact.gfa").toStdString();
+    cmd.m_out = tempFile("test_compact.gfa").toStdString();
+    QCOMPARE(handleCompactCmd(nullptr, CLI::App(), cmd), 0);
+
+    //Nodes 1, 2 and 3 form the only non-branching chain, the paths through
+    //them should now go through the merged node.
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(tempFile("test_compact.gfa")));
+    QCOMPARE(g_assemblyGraph->m_nodeCount, 3);
+    QCOMPARE(g_assemblyGraph->m_edgeCount, 2);
+    QCOMPARE(g_assemblyGraph->pathCount(), 2);
+
+    DeBruijnNode * mergedNode = g_assemblyGraph->m_deBruijnGraphNodes["1_2_3+"];
+    if (mergedNode == nullptr)
+        mergedNode = g_assemblyGraph->m_deBruijnGraphNodes["3_2_1-"];
+
+    QVERIFY(mergedNode != nullptr);
+    QCOMPARE(mergedNode->getSequence(), Sequence(QByteArray("CATGCCTTCTGTGCGAGCCCCCGCTCGGAGTCTGGGGAGTCTCCCTCTTA")));
+
+    Path path1 = g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["p1"]);
+    QCOMPARE(path1.getNodeCount(), 2);
+    QCOMPARE(path1.nodes().front(), mergedNode);
+    QCOMPARE(path1.getPathSequence(), path1Sequence);
+    QCOMPARE(g_assemblyGraph->getPath(g_assemblyGraph->m_deBruijnGraphPaths["p2"]).getNodeCount(), 2);
+}
+
 
 
 void BandageTests::changeNodeNames()
@@ -1470,6 +1786,19 @@ void BandageTests::changeNodeNames()
     QCOMPARE(node6Plus, node12345Plus);
     QCOMPARE(node6Minus, node12345Minus);
     QCOMPARE(nodeCountBefore, nodeCountAfter);
+    QCOMPARE(node12345Plus->getName(), QString("12345+"));
+    QCOMPARE(node12345Minus->getName(), QString("12345-"));
+    QCOMPARE(node12345Plus->getBaseName().data(), node12345Minus->getBaseName().data());
+
+    // Non-ASCII names use the same encoding in the node map and the node
+    g_assemblyGraph->changeNodeName("12345", QString::fromUtf8("contig_\xc3\xa9"));
+    QCOMPARE(node12345Plus->getName(), QString::fromUtf8("contig_\xc3\xa9+"));
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes[node12345Plus->getStdName()], node12345Plus);
+    QCOMPARE(g_assemblyGraph->m_deBruijnGraphNodes[node12345Plus->getName().toStdString()], node12345Plus);
+
+    // Chromosome-scale lengths are not truncated
+    node12345Plus->setSequence(Sequence(size_t(3'000'000'000), true));
+    QCOMPARE(node12345Plus->getLength(), 3'000'000'000u);
 }
 
 void BandageTests::changeNodeDepths()
@@ -1652,6 +1981,37 @@ void BandageTests::blastQueryPaths() {
 }
 
 
+void BandageTests::allPossiblePaths() {
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test_query_paths.gfa")));
+
+    DeBruijnNode * node1 = g_assemblyGraph->m_deBruijnGraphNodes["1+"];
+    DeBruijnNode * node4 = g_assemblyGraph->m_deBruijnGraphNodes["4+"];
+    DeBruijnNode * node6 = g_assemblyGraph->m_deBruijnGraphNodes["6+"];
+    DeBruijnNode * node8 = g_assemblyGraph->m_deBruijnGraphNodes["8+"];
+    GraphLocation start = GraphLocation::startOfNode(node1);
+    GraphLocation end = GraphLocation::endOfNode(node8);
+
+    //The only path from 1+ to 8+ goes through 4+ and 6+ and is 13000 bp long.
+    bool truncated = true;
+    QList<Path> paths = Path::getAllPossiblePaths(start, end, 5, 1, 20000, &truncated);
+    QCOMPARE(paths.size(), 1);
+    QVERIFY(!truncated);
+    std::vector<DeBruijnNode *> expectedNodes{node1, node4, node6, node8};
+    QCOMPARE(paths.front().nodes(), expectedNodes);
+    QCOMPARE(paths.front().getLength(), 13000);
+
+    //It needs three edges and must fit into the length range.
+    QCOMPARE(Path::getAllPossiblePaths(start, end, 3, 1, 20000).size(), 1);
+    QCOMPARE(Path::getAllPossiblePaths(start, end, 2, 1, 20000).size(), 0);
+    QCOMPARE(Path::getAllPossiblePaths(start, end, 5, 1, 12999).size(), 0);
+    QCOMPARE(Path::getAllPossiblePaths(start, end, 5, 13001, 20000).size(), 0);
+
+    //A path may start and end within the same node.
+    paths = Path::getAllPossiblePaths(GraphLocation(node4, 101), GraphLocation(node4, 200), 5, 1, 20000);
+    QCOMPARE(paths.size(), 1);
+    QCOMPARE(paths.front().getLength(), 100);
+}
+
 void BandageTests::bandageInfo()
 {
     int n50 = 0;
@@ -1663,6 +2023,38 @@ void BandageTests::bandageInfo()
     int componentCount = 0;
     int largestComponentLength = 0;
 
+    // The fused statistics pass must agree with the individual getters
+    auto checkGraphStats = [&]() {
+        graph::GraphStats stats = graph::computeGraphStats(*g_assemblyGraph);
+        QCOMPARE(stats.nodeCount, g_assemblyGraph->m_nodeCount);
+        QCOMPARE(stats.edgeCount, g_assemblyGraph->m_edgeCount);
+        QCOMPARE(stats.totalLength, g_assemblyGraph->m_totalLength);
+        QCOMPARE(stats.smallestOverlap, g_assemblyGraph->getOverlapRange().first);
+        QCOMPARE(stats.largestOverlap, g_assemblyGraph->getOverlapRange().second);
+        QCOMPARE(stats.totalLengthNoOverlaps, g_assemblyGraph->getTotalLengthMinusEdgeOverlaps());
+        QCOMPARE(stats.deadEnds, g_assemblyGraph->getDeadEndCount());
+        QCOMPARE(stats.totalLengthOrphanedNodes, g_assemblyGraph->getTotalLengthOrphanedNodes());
+        QCOMPARE(stats.componentCount, componentCount);
+        QCOMPARE(stats.largestComponentLength, (long long)largestComponentLength);
+        QCOMPARE(stats.n50, n50);
+        QCOMPARE(stats.shortestNode, shortestNode);
+        QCOMPARE(stats.firstQuartile, firstQuartile);
+        QCOMPARE(stats.median, median);
+        QCOMPARE(stats.thirdQuartile, thirdQuartile);
+        QCOMPARE(stats.longestNode, longestNode);
+        double medianDepthByBase = g_assemblyGraph->getMedianDepthByBase();
+        QCOMPARE(stats.medianDepthByBase, medianDepthByBase);
+        QCOMPARE(stats.estimatedSequenceLength, g_assemblyGraph->getEstimatedSequenceLength(medianDepthByBase));
+
+        unsigned componentNodes = 0, components = 0;
+        for (auto [size, count] : stats.componentSizes) {
+            componentNodes += size * count;
+            components += count;
+        }
+        QCOMPARE(componentNodes, unsigned(stats.nodeCount));
+        QCOMPARE(components, unsigned(stats.componentCount));
+    };
+
     QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.fastg")));
     g_assemblyGraph->getNodeStats(&n50, &shortestNode, &firstQuartile, &median, &thirdQuartile, &longestNode);
     g_assemblyGraph->getGraphComponentCountAndLargestComponentSize(&componentCount, &largestComponentLength);
@@ -1675,6 +2067,29 @@ void BandageTests::bandageInfo()
     QCOMPARE(52213, longestNode);
     QCOMPARE(1, componentCount);
     QCOMPARE(214441, largestComponentLength);
+    checkGraphStats();
+
+    // Negative nodes must not own a separate sequence buffer
+    size_t unsharedSequenceBytes = 0, storedSequenceBytes = 0;
+    g_assemblyGraph->getPackedSequenceMemory(&unsharedSequenceBytes, &storedSequenceBytes);
+    QCOMPARE(unsharedSequenceBytes, 2 * storedSequenceBytes);
+    for (auto *node : g_assemblyGraph->m_deBruijnGraphNodes)
+        QCOMPARE(node->getSequence().buffer(), node->getReverseComplement()->getSequence().buffer());
+
+    // All-N sequences store no packed data, so they are not accounted
+    {
+        auto *positive = g_assemblyGraph->createNode("unknown+", 1.0f, Sequence(1000, true));
+        auto *negative = g_assemblyGraph->createNode("unknown-", 1.0f, Sequence(1000, true));
+        positive->setReverseComplement(negative);
+        negative->setReverseComplement(positive);
+        g_assemblyGraph->m_deBruijnGraphNodes.emplace("unknown+", positive);
+        g_assemblyGraph->m_deBruijnGraphNodes.emplace("unknown-", negative);
+
+        size_t unknownUnsharedBytes = 0, unknownStoredBytes = 0;
+        g_assemblyGraph->getPackedSequenceMemory(&unknownUnsharedBytes, &unknownStoredBytes);
+        QCOMPARE(unknownUnsharedBytes, unsharedSequenceBytes);
+        QCOMPARE(unknownStoredBytes, storedSequenceBytes);
+    }
 
     QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.Trinity.fasta")));
     g_assemblyGraph->getNodeStats(&n50, &shortestNode, &firstQuartile, &median, &thirdQuartile, &longestNode);
@@ -1682,6 +2097,7 @@ void BandageTests::bandageInfo()
     QCOMPARE(149, g_assemblyGraph->getDeadEndCount());
     QCOMPARE(66, componentCount);
     QCOMPARE(9398, largestComponentLength);
+    checkGraphStats();
 
     QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.gfa")));
     g_assemblyGraph->getNodeStats(&n50, &shortestNode, &firstQuartile, &median, &thirdQuartile, &longestNode);
@@ -1695,6 +2111,42 @@ void BandageTests::bandageInfo()
     QCOMPARE(2060, longestNode);
     QCOMPARE(1, componentCount);
     QCOMPARE(30959, largestComponentLength);
+    checkGraphStats();
+}
+
+void BandageTests::nodeMetrics()
+{
+    QVERIFY(g_assemblyGraph->loadGraphFromFile(testFile("test.fastg")));
+
+    // Metrics are cached for every node once the graph is loaded
+    const auto &metrics = g_assemblyGraph->m_nodeMetrics;
+    QVERIFY(!metrics.empty());
+    auto checkMetrics = [&]() {
+        for (auto *node : g_assemblyGraph->m_deBruijnGraphNodes) {
+            graph::NodeMetrics nodeMetrics = metrics.get(node);
+            QCOMPARE(nodeMetrics.gc, node->getGC());
+            QCOMPARE(nodeMetrics.trimmedLength, node->getLengthWithoutTrailingOverlap());
+            QCOMPARE(size_t(nodeMetrics.inDegree), node->getEnteringEdges().size());
+            QCOMPARE(size_t(nodeMetrics.outDegree), node->getLeavingEdges().size());
+            double depthRange = g_assemblyGraph->m_thirdQuartileDepth - g_assemblyGraph->m_firstQuartileDepth;
+            QCOMPARE(nodeMetrics.depthFraction,
+                     float((node->getDepth() - g_assemblyGraph->m_firstQuartileDepth) / depthRange));
+        }
+    };
+    checkMetrics();
+
+    // Node edits invalidate the cache, metrics are computed on the fly until
+    // the graph info is updated
+    std::vector<DeBruijnNode *> nodes = { g_assemblyGraph->m_deBruijnGraphNodes["1+"] };
+    g_assemblyGraph->changeNodeDepth(nodes, 1000.0);
+    QVERIFY(metrics.empty());
+    checkMetrics();
+
+    g_assemblyGraph->determineGraphInfo();
+    QVERIFY(!metrics.empty());
+    checkMetrics();
+    // The node depth is now well above the third quartile
+    QVERIFY(metrics.get(nodes.front()).depthFraction > 1.0f);
 }
 
 void BandageTests::sequenceInit() {
@@ -1721,6 +2173,22 @@ void BandageTests::sequenceInitN() {
     QCOMPARE(sequenceFromStringLower, sequenceFromQByteArray);
 }
 
+void BandageTests::sequenceMissing() {
+    Sequence missing(100000000, /* allNs */ true);
+    QVERIFY(missing.missing());
+    QCOMPARE(missing.bufferCapacity(), size_t(0));
+    QCOMPARE(missing[12345], 'N');
+    QVERIFY(missing.GetReverseComplement().missing());
+    QCOMPARE(Sequence(5, /* allNs */ true).str(), std::string("NNNNN"));
+    QCOMPARE(Sequence(5, /* allNs */ true), Sequence{"NNNNN"});
+
+    Sequence partial{"ACNNGTN"};
+    QVERIFY(!partial.missing());
+    QVERIFY(partial.Subseq(2, 4).missing());
+    QVERIFY(!partial.Subseq(1, 4).missing());
+    QCOMPARE(partial.GetReverseComplement().str(), std::string("NACNNGT"));
+}
+
 void BandageTests::sequenceAccess() {
     Sequence sequence{"ATGCN"};
 
@@ -1772,6 +2240,45 @@ void BandageTests::sequenceDoubleReverseComplement() {
     QCOMPARE(sequence, sequence.GetReverseComplement().GetReverseComplement());
 }
 
+void BandageTests::sequenceKernels() {
+    // Long enough for word-at-a-time and SIMD paths, with runs of N's
+    // crossing the word boundaries
+    std::string str;
+    unsigned state = 1;
+    for (size_t i = 0; i < 1000; ++i) {
+        state = state * 1103515245 + 12345;
+        str += (i % 97 >= 60 && i % 97 < 75) ? 'N' : "ACGT"[(state >> 16) & 3];
+    }
+    Sequence sequence{str};
+
+    auto checkSequence = [](const Sequence &seq) {
+        std::string expected;
+        size_t gc = 0;
+        for (size_t i = 0; i < seq.size(); ++i) {
+            expected += seq[i];
+            gc += (seq[i] == 'G' || seq[i] == 'C');
+        }
+        QVERIFY(seq.str() == expected);
+        QCOMPARE(seq.gcCount(), gc);
+        QCOMPARE(utils::sequenceToQByteArray(seq), QByteArray::fromStdString(expected));
+    };
+
+    for (size_t from : { 0, 1, 3, 31, 32, 33, 61, 100, 500 }) {
+        for (size_t to : { 999, 1000, 900, 700, 129, 128, 65 }) {
+            if (from > to)
+                continue;
+            checkSequence(sequence.Subseq(from, to));
+            checkSequence(sequence.Subseq(from, to).GetReverseComplement());
+            checkSequence(sequence.GetReverseComplement().Subseq(from, to));
+        }
+    }
+
+    QCOMPARE(sequence.str(), str);
+    QCOMPARE(Sequence(100, true).str(), std::string(100, 'N'));
+    QCOMPARE(Sequence(100, true).gcCount(), size_t(0));
+    QCOMPARE(Sequence("GCNNGC").gcCount(), size_t(4));
+}
+
 
 
 
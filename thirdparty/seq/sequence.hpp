@@ -12,21 +12,185 @@
 #include "utils/sfinae_checks.hpp"
 
 #include <llvm/ADT/IntrusiveRefCntPtr.h>
-#include <llvm/ADT/SparseBitVector.h>
+#include <llvm/ADT/bit.h>
+#include <llvm/Support/Compiler.h>
 #include <llvm/Support/TrailingObjects.h>
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <memory>
 #include <sstream>
 #include <cstring>
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SEQ_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
 // Silence bogus gcc warnings
 #if defined(__GCC__)
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wconversion"
 #endif
 
+// Word-at-a-time and SIMD kernels working directly on the packed 2-bit
+// representation. Nucleotide i is stored in bits [2*(i%32), 2*(i%32)+2) of
+// the word i/32, so packed byte j (in little-endian order) holds nucleotides
+// [4*j, 4*j+4). Kernels requiring extra ISA extensions are selected at runtime.
+namespace seq_kernels {
+
+using Word = uint64_t;
+
+static constexpr Word LowBits = 0x5555555555555555ULL;
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE inline size_t popcount(Word w) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(w);
+#else
+    return llvm::popcount(w);
+#endif
+}
+
+// Number of G / C nucleotides in packed word, taking only nucleotides set in mask
+// into account. A = 00, C = 01, G = 10, T = 11, so G / C are exactly the
+// nucleotides with different low and high bit.
+LLVM_ATTRIBUTE_ALWAYS_INLINE inline Word gcBits(Word w, Word mask) {
+    return (w ^ (w >> 1)) & mask;
+}
+
+// Counts G / C nucleotides in packed nucleotides [from, to), from < to
+LLVM_ATTRIBUTE_ALWAYS_INLINE inline size_t gcCountImpl(const Word *words, size_t from, size_t to) {
+    size_t first = from >> 5, last = (to - 1) >> 5;
+    Word headMask = LowBits << ((from & 31) << 1);
+    Word tailMask = LowBits >> ((31 - ((to - 1) & 31)) << 1);
+    if (first == last)
+        return popcount(gcBits(words[first], headMask & tailMask));
+
+    size_t res = popcount(gcBits(words[first], headMask));
+    for (size_t i = first + 1; i < last; ++i)
+        res += popcount(gcBits(words[i], LowBits));
+    return res + popcount(gcBits(words[last], tailMask));
+}
+
+inline size_t gcCountGeneric(const Word *words, size_t from, size_t to) {
+    return gcCountImpl(words, from, to);
+}
+
+#ifdef SEQ_KERNELS_X86
+// Same as above, but builtin popcount is expanded to a single instruction
+__attribute__((target("popcnt")))
+inline size_t gcCountPopcnt(const Word *words, size_t from, size_t to) {
+    return gcCountImpl(words, from, to);
+}
+#endif
+
+inline size_t gcCount(const Word *words, size_t from, size_t to) {
+    using Fn = size_t (*)(const Word *, size_t, size_t);
+#ifdef SEQ_KERNELS_X86
+    static const Fn fn = __builtin_cpu_supports("popcnt") ? gcCountPopcnt : gcCountGeneric;
+#else
+    static const Fn fn = gcCountGeneric;
+#endif
+    return fn(words, from, to);
+}
+
+// Four ASCII nucleotides for every possible packed byte
+struct DecodeTable {
+    char chars[256][4];
+};
+
+constexpr DecodeTable makeDecodeTable(bool complement) {
+    DecodeTable table{};
+    const char *nucls = complement ? "TGCA" : "ACGT";
+    for (unsigned b = 0; b < 256; ++b)
+        for (unsigned k = 0; k < 4; ++k)
+            table.chars[b][k] = nucls[(b >> (2 * k)) & 3];
+    return table;
+}
+
+inline constexpr DecodeTable ForwardTable = makeDecodeTable(false);
+inline constexpr DecodeTable ComplementTable = makeDecodeTable(true);
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE inline uint8_t packedByte(const Word *words, size_t idx) {
+    return uint8_t(words[idx >> 3] >> ((idx & 7) << 3));
+}
+
+// Decodes packed bytes [begin, end) into 4 * (end - begin) characters
+inline void decodeBytesGeneric(const Word *words, size_t begin, size_t end, bool complement, char *out) {
+    const DecodeTable &table = complement ? ComplementTable : ForwardTable;
+    for (size_t i = begin; i < end; ++i, out += 4)
+        memcpy(out, table.chars[packedByte(words, i)], 4);
+}
+
+#ifdef SEQ_KERNELS_X86
+// Decodes 16 packed bytes into 64 characters at once. Every byte is split into
+// nibbles, nibbles are spread two lanes each and masked with 0x03 / 0x0C, so
+// every lane contains either n or 4*n for a nucleotide n. Both are mapped to
+// ASCII by a single 16-entry table lookup.
+__attribute__((target("ssse3")))
+inline void decodeBytesSSSE3(const Word *words, size_t begin, size_t end, bool complement, char *out) {
+    const __m128i lut = complement ?
+                        _mm_setr_epi8('T', 'G', 'C', 'A', 'G', 0, 0, 0, 'C', 0, 0, 0, 'A', 0, 0, 0) :
+                        _mm_setr_epi8('A', 'C', 'G', 'T', 'C', 0, 0, 0, 'G', 0, 0, 0, 'T', 0, 0, 0);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i mask = _mm_set1_epi16(0x0C03);
+    const __m128i spreadLo = _mm_setr_epi8(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+    const __m128i spreadHi = _mm_setr_epi8(8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15);
+
+    const char *bytes = reinterpret_cast<const char*>(words);
+    size_t i = begin;
+    for (; i + 16 <= end; i += 16, out += 64) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        __m128i lo = _mm_and_si128(in, nibble);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(in, 4), nibble);
+        // Nibbles in nucleotide order: lo0, hi0, lo1, hi1, ...
+        __m128i n0 = _mm_unpacklo_epi8(lo, hi), n1 = _mm_unpackhi_epi8(lo, hi);
+        __m128i v0 = _mm_and_si128(_mm_shuffle_epi8(n0, spreadLo), mask);
+        __m128i v1 = _mm_and_si128(_mm_shuffle_epi8(n0, spreadHi), mask);
+        __m128i v2 = _mm_and_si128(_mm_shuffle_epi8(n1, spreadLo), mask);
+        __m128i v3 = _mm_and_si128(_mm_shuffle_epi8(n1, spreadHi), mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(lut, v0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_shuffle_epi8(lut, v1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), _mm_shuffle_epi8(lut, v2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 48), _mm_shuffle_epi8(lut, v3));
+    }
+
+    decodeBytesGeneric(words, i, end, complement, out);
+}
+#endif
+
+// Decodes packed nucleotides [from, from + size) into ASCII, complementing
+// them if requested
+inline void decode(const Word *words, size_t from, size_t size, bool complement, char *out) {
+    using Fn = void (*)(const Word *, size_t, size_t, bool, char *);
+#ifdef SEQ_KERNELS_X86
+    static const Fn decodeBytes = __builtin_cpu_supports("ssse3") ? decodeBytesSSSE3 : decodeBytesGeneric;
+#else
+    static const Fn decodeBytes = decodeBytesGeneric;
+#endif
+    const char *nucls = complement ? "TGCA" : "ACGT";
+    auto decodeOne = [&](size_t i) {
+        return nucls[(words[i >> 5] >> ((i & 31) << 1)) & 3];
+    };
+
+    size_t i = from, end = from + size;
+    for (; i < end && (i & 3); ++i)
+        *out++ = decodeOne(i);
+
+    size_t bytesBegin = i >> 2, bytesEnd = end >> 2;
+    if (bytesBegin < bytesEnd) {
+        decodeBytes(words, bytesBegin, bytesEnd, complement, out);
+        out += (bytesEnd - bytesBegin) << 2;
+        i = bytesEnd << 2;
+    }
+
+    for (; i < end; ++i)
+        *out++ = decodeOne(i);
+}
+
+}
+
 class Sequence {
     // Type to store Seq in Sequences
     typedef uint64_t ST;
@@ -37,13 +201,24 @@ class Sequence {
     // Number of bits in STN (for faster div and mod)
     const static size_t STNBits = log_<STN, 2>::value;
 
+    // Run of unknown (N) nucleotides, [start, end) in buffer coordinates
+    struct NRun {
+        size_t start, end;
+
+        bool operator==(const NRun &that) const {
+            return start == that.start && end == that.end;
+        }
+    };
+
     class ManagedNuclBuffer final : public llvm::ThreadSafeRefCountedBase<ManagedNuclBuffer>,
                                     protected llvm::TrailingObjects<ManagedNuclBuffer, ST> {
         friend TrailingObjects;
 
-        ManagedNuclBuffer() {}
+        explicit ManagedNuclBuffer(size_t nucls)
+                : nucls_(nucls) {}
 
-        ManagedNuclBuffer(size_t nucls, ST *buf) {
+        ManagedNuclBuffer(size_t nucls, ST *buf)
+                : nucls_(nucls) {
             std::uninitialized_copy(buf, buf + Sequence::DataSize(nucls), data());
         }
 
@@ -52,7 +227,7 @@ class Sequence {
 
         static ManagedNuclBuffer *create(size_t nucls) {
             void *mem = ::operator new(totalSizeToAlloc<ST>(Sequence::DataSize(nucls)));
-            return new (mem) ManagedNuclBuffer();
+            return new (mem) ManagedNuclBuffer(nucls);
         }
 
         static ManagedNuclBuffer *create(size_t nucls, ST *data) {
@@ -63,7 +238,13 @@ class Sequence {
         const ST *data() const { return getTrailingObjects<ST>(); }
         ST *data() { return getTrailingObjects<ST>(); }
 
-        std::unique_ptr<llvm::SparseBitVector<>> empty_nucls_ = nullptr;
+        // Number of nucleotides with packed storage. Fully unknown sequences
+        // store no packed data at all, just a single run of N's.
+        size_t size() const { return nucls_; }
+
+        size_t nucls_;
+        // Sorted, non-adjacent runs of N's
+        std::vector<NRun> empty_nucls_;
     };
 
     size_t size_ : 32;
@@ -83,12 +264,13 @@ class Sequence {
         int step = rc ? -1 : 1;
         int cur_index = 0;
 
+        auto &runs = data_->empty_nucls_;
         for (int i = start; i != end; i += step) {
             if (LLVM_UNLIKELY(is_N(s[i]))) {
-                if (LLVM_UNLIKELY(data_->empty_nucls_ == nullptr)) {
-                    data_->empty_nucls_ = std::make_unique<llvm::SparseBitVector<>>();
-                }
-                data_->empty_nucls_->set(cur_index);
+                if (!runs.empty() && runs.back().end == size_t(cur_index))
+                    runs.back().end += 1;
+                else
+                    runs.push_back({size_t(cur_index), size_t(cur_index) + 1});
             }
             cur_index++;
         }
@@ -149,11 +331,19 @@ class Sequence {
             bytes[cur] = 0;
     }
 
+    // Returns the first run of N's that ends after idx
+    std::vector<NRun>::const_iterator findEmptyRun(size_t idx) const {
+        const auto &runs = data_->empty_nucls_;
+        return std::upper_bound(runs.begin(), runs.end(), idx,
+                                [](size_t i, const NRun &run) { return i < run.end; });
+    }
+
     bool isEmptySymbol(size_t idx) const {
-        if (LLVM_LIKELY(data_->empty_nucls_ == nullptr)) {
+        if (LLVM_LIKELY(data_->empty_nucls_.empty())) {
             return false;
         }
-        return data_->empty_nucls_->test(idx);
+        auto it = findEmptyRun(idx);
+        return it != data_->empty_nucls_.end() && it->start <= idx;
     }
 
     char getNuclFromBuffer(size_t idx) const {
@@ -162,10 +352,7 @@ class Sequence {
     }
 
     bool emptyNuclsEqual(const Sequence &that) const {
-        return data_->empty_nucls_ == that.data_->empty_nucls_
-            || (data_->empty_nucls_ != nullptr
-                && that.data_->empty_nucls_ != nullptr
-                && *data_->empty_nucls_ == *that.data_->empty_nucls_);
+        return data_->empty_nucls_ == that.data_->empty_nucls_;
     }
 
     //Low level constructor. Handle with care.
@@ -173,13 +360,12 @@ class Sequence {
             : size_(size), from_(from), rtl_(rtl), data_(seq.data_) {}
 
 public:
+    // Fully unknown sequences (allNs) are O(1) to create and store: no packed
+    // buffer is allocated, there is only a single run of N's.
     explicit Sequence(size_t size, bool allNs = false)
-            : size_(size), from_(0), rtl_(false), data_(ManagedNuclBuffer::create(size_)) {
-        if (allNs) {
-            data_->empty_nucls_ = std::make_unique<llvm::SparseBitVector<>>();
-            for (size_t i = from_; i < size_; ++i)
-                data_->empty_nucls_->set(i);
-        }
+            : size_(size), from_(0), rtl_(false), data_(ManagedNuclBuffer::create(allNs ? 0 : size_)) {
+        if (allNs && size_ > 0)
+            data_->empty_nucls_.push_back({0, size_});
     }
 
     /**
@@ -308,6 +494,50 @@ public:
 
     inline std::string str() const;
 
+    // Writes size() ACGTN characters to out
+    void copyTo(char *out) const {
+        if (size_ == 0)
+            return;
+
+        // Fully unknown sequences have no packed data
+        if (data_->size() == 0) {
+            memset(out, 'N', size_);
+            return;
+        }
+
+        // Reverse complement is decoded as complement of the forward strand
+        // and reversed afterwards
+        seq_kernels::decode(data_->data(), from_, size_, rtl_, out);
+        if (rtl_)
+            std::reverse(out, out + size_);
+
+        const auto &runs = data_->empty_nucls_;
+        for (auto it = findEmptyRun(from_); it != runs.end() && it->start < from_ + size_; ++it) {
+            size_t start = std::max<size_t>(it->start, from_) - from_;
+            size_t end = std::min<size_t>(it->end, from_ + size_) - from_;
+            if (rtl_)
+                memset(out + size_ - end, 'N', end - start);
+            else
+                memset(out + start, 'N', end - start);
+        }
+    }
+
+    // Number of G and C nucleotides, N's are not counted
+    size_t gcCount() const {
+        if (size_ == 0 || data_->size() == 0)
+            return 0;
+
+        // Complement preserves G / C, so the strand does not matter
+        const ST *words = data_->data();
+        size_t res = seq_kernels::gcCount(words, from_, from_ + size_);
+        const auto &runs = data_->empty_nucls_;
+        for (auto it = findEmptyRun(from_); it != runs.end() && it->start < from_ + size_; ++it)
+            res -= seq_kernels::gcCount(words,
+                                        std::max<size_t>(it->start, from_),
+                                        std::min<size_t>(it->end, from_ + size_));
+        return res;
+    }
+
     inline std::string err() const;
 
     size_t size() const {
@@ -318,17 +548,30 @@ public:
         return DataSize(size_) * sizeof(ST);
     }
 
+    // Identity of the packed buffer. Subsequences and reverse complements
+    // share the buffer of the sequence they were created from.
+    const void *buffer() const {
+        return data_.get();
+    }
+
+    // Size of the whole packed buffer (might be larger than capacity() for views)
+    size_t bufferCapacity() const {
+        return DataSize(data_->size()) * sizeof(ST);
+    }
+
     bool empty() const {
         return size() == 0;
     }
 
     bool missing() const {
         // No N's - nothing is missed
-        if (!data_->empty_nucls_)
+        if (data_->empty_nucls_.empty())
             return false;
 
-        // All N's are set
-        return size_ == data_->empty_nucls_->count();
+        // All N's are set. Runs are never adjacent, so the whole sequence must
+        // be covered by a single one.
+        auto it = findEmptyRun(from_);
+        return it != data_->empty_nucls_.end() && it->start <= from_ && it->end >= from_ + size_;
     }
 
     template<class Seq>
@@ -413,9 +656,7 @@ Sequence Sequence::operator+(const Sequence &s) const {
 
 std::string Sequence::str() const {
     std::string res(size_, '-');
-    for (size_t i = 0; i < size_; ++i) {
-        res[i] = nucl(this->operator[](i));
-    }
+    copyTo(res.data());
     return res;
 }
 
@@ -425,7 +666,7 @@ std::string Sequence::err() const {
             ", from_=" << from_ <<
             ", size_=" << size_ <<
             ", rtl_=" << int(rtl_) <<
-            ", empty_nucls_=" << data_->empty_nucls_.get() << " }";
+            ", empty_nucls_=" << data_->empty_nucls_.size() << " runs }";
     return oss.str();
 }
 
@@ -18,14 +18,13 @@ AnnotationSettingsDialog::AnnotationSettingsDialog(const AnnotationGroup &annota
     connect(textCheckBox, &QCheckBox::stateChanged,
             [this](int newState) {
                 g_settings->annotationsSettings[m_annotationGroupId].showText = newState == Qt::Checked;
-                g_graphicsView->viewport()->update();
+                g_graphicsView->updateViewportUpdateMode();
             });
 
     formLayout->addRow(textCheckBox);
-    if (!annotationGroup.annotationMap.empty() && !annotationGroup.annotationMap.begin()->second.empty()) {
-        // All annotations in group have the same types of views, so we can get view's names from any annotation
+    if (!annotationGroup.annotations.empty()) {
         ViewId i = 0;
-        for (const auto &view: annotationGroup.annotationMap.begin()->second.front()->getViews()) {
+        for (const auto &view: annotationGroup.views) {
             auto viewCheckBox = new QCheckBox(view->getTypeName());
             viewCheckBox->setCheckState(annotationSettings.viewsToShow.count(i) != 0 ? Qt::Checked : Qt::Unchecked);
             formLayout->addRow(viewCheckBox);
@@ -74,4 +73,7 @@ void AnnotationsListWidget::updateAnnotationGroups() {
         addItem(listWidgetItem);
         listWidgetItem->setData(Qt::UserRole, annotationGroupPtr->id);
     }
+
+    // New groups might display text
+    g_graphicsView->updateViewportUpdateMode();
 }
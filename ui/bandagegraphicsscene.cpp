@@ -201,9 +201,29 @@ void BandageGraphicsScene::possiblyExpandSceneRectangle(std::vector<GraphicsItem
         setSceneRect(newSceneRect);
 }
 
+// Depth of the BSP tree used to index a scene of the given size. Each level
+// halves the leaf area, so aim for a few dozen items per leaf.
+static int bspTreeDepthForItemCount(size_t itemCount) {
+    constexpr size_t ItemsPerLeaf = 32;
+    constexpr int MinDepth = 5, MaxDepth = 18;
+
+    int depth = MinDepth;
+    while (depth < MaxDepth && (size_t(1) << depth) * ItemsPerLeaf < itemCount)
+        ++depth;
+
+    return depth;
+}
+
+// Creates graphics items for all drawn nodes and edges. Inserting items one by
+// one into an indexed scene keeps updating the BSP tree, so the items are
+// added with indexing disabled and the tree is then built once with a depth
+// fixed for the number of items. The scene rectangle is also set here, as the
+// index covers it.
 void BandageGraphicsScene::addGraphicsItemsToScene(AssemblyGraph &graph,
                                                    const GraphLayout &layout) {
     clear();
+    setItemIndexMethod(QGraphicsScene::NoIndex);
+    size_t itemCount = 0;
 
     double meanDrawnDepth = graph.getMeanDepth(true);
 
@@ -253,6 +273,7 @@ void BandageGraphicsScene::addGraphicsItemsToScene(AssemblyGraph &graph,
         edge->setGraphicsItemEdge(graphicsItemEdge);
         graphicsItemEdge->setFlag(QGraphicsItem::ItemIsSelectable);
         addItem(graphicsItemEdge);
+        itemCount += 1;
     }
 
     // Now add the GraphicsItemNode objects to the scene, so they are drawn
@@ -262,7 +283,12 @@ void BandageGraphicsScene::addGraphicsItemsToScene(AssemblyGraph &graph,
             continue;
 
         addItem(node->getGraphicsItemNode());
+        itemCount += 1;
     }
+
+    setSceneRectangle();
+    setBspTreeDepth(bspTreeDepthForItemCount(itemCount));
+    setItemIndexMethod(QGraphicsScene::BspTreeIndex);
 }
 
 void BandageGraphicsScene::removeAllGraphicsEdgesFromNode(DeBruijnNode *node, bool reverseComplement) {
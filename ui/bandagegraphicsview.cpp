@@ -18,26 +18,83 @@
 
 #include "bandagegraphicsview.h"
 #include "graph/graphicsitemnode.h"
+#include "graph/annotationsmanager.h"
 #include "program/globals.h"
 #include "program/settings.h"
 #include "graphicsviewzoom.h"
 #include <QMouseEvent>
+#include <QPaintEvent>
 #include <QFont>
 #include <QMessageBox>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
 #include <qmath.h>
 #include <cmath>
 
+// Per-frame paint profiling, enabled via QT_LOGGING_RULES="bandage.paint.debug=true"
+Q_LOGGING_CATEGORY(lcPaint, "bandage.paint", QtWarningMsg)
+
 BandageGraphicsView::BandageGraphicsView(QObject * /*parent*/) :
     QGraphicsView(), m_rotation(0.0)
 {
     setDragMode(QGraphicsView::RubberBandDrag);
     setAntialiasing(g_settings->antialiasing);
-    setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+    updateViewportUpdateMode();
     setBackgroundBrush(QBrush(Qt::white));
 }
 
 
 
+//Node and annotation labels are drawn outside of the items' bounding
+//rectangles, so they need the whole viewport to be repainted.
+static bool anyTextDisplayed()
+{
+    if (g_settings->displayNodeCustomLabels ||
+        g_settings->displayNodeNames ||
+        g_settings->displayNodeLengths ||
+        g_settings->displayNodeDepth ||
+        g_settings->displayNodeCsvData)
+        return true;
+
+    if (!g_annotationsManager)
+        return false;
+
+    for (const auto &annotationGroup : g_annotationsManager->getGroups())
+        if (g_settings->annotationsSettings[annotationGroup->id].showText)
+            return true;
+
+    return false;
+}
+
+//Only repaint the changed regions when nothing is drawn outside of the
+//items. Needs to be called every time the label or annotation text settings
+//are changed.
+void BandageGraphicsView::updateViewportUpdateMode()
+{
+    setViewportUpdateMode(anyTextDisplayed() ? QGraphicsView::FullViewportUpdate
+                                             : QGraphicsView::SmartViewportUpdate);
+    viewport()->update();
+}
+
+void BandageGraphicsView::paintEvent(QPaintEvent * event)
+{
+    if (!lcPaint().isDebugEnabled())
+    {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+
+    //The stroke count covers everything since the previous frame, including
+    //outlines rebuilt while dragging nodes.
+    qCDebug(lcPaint) << "frame:" << timer.elapsed() << "ms,"
+                     << g_outlineStrokeCount << "stroker invocations";
+    g_outlineStrokeCount = 0;
+}
+
 void BandageGraphicsView::mousePressEvent(QMouseEvent * event)
 {
     if (event->modifiers() == Qt::CTRL)
@@ -46,11 +46,13 @@ public:
     QPoint m_previousPos;
 
     void setAntialiasing(bool antialiasingOn);
+    void updateViewportUpdateMode();
     bool isPointVisible(QPointF p);
     QPointF findIntersectionWithViewportBoundary(QLineF line);
     QLineF findVisiblePartOfLine(QLineF line, bool * success);
 
 protected:
+    void paintEvent(QPaintEvent * event) override;
     void mousePressEvent(QMouseEvent * event);
     void mouseReleaseEvent(QMouseEvent * event);
     void mouseMoveEvent(QMouseEvent * event);
@@ -654,6 +654,11 @@ QVariant QueriesListModel::data(const QModelIndex &index, int role) const {
     if (role == Qt::EditRole && column == QueriesHitColumns::QueryName)
         return query->getName();
 
+    if (role == Qt::ToolTipRole && column == QueriesHitColumns::Paths &&
+        query->isPathSearchTruncated())
+        return QString("Path search stopped after %1 candidate paths, "
+                       "some paths may be missing").arg(Path::MaxPathSearchCandidates);
+
     if (role != Qt::DisplayRole)
         return {};
 
@@ -781,6 +786,9 @@ void PathButtonDelegate::paint(QPainter *painter, const QStyleOptionViewItem &op
         btn.rect = option.rect;
         btn.state = option.state | QStyle::State_Enabled | QStyle::State_Raised;
         btn.text = QString::number(query->getPathCount());
+        // Search stopped early, there could be more paths
+        if (query->isPathSearchTruncated())
+            btn.text += "+";
 
         QStyle *style = option.widget ? option.widget->style() : QApplication::style();
         style->drawControl(QStyle::CE_PushButton, &btn, painter);
@@ -25,6 +25,11 @@
 #include <QPushButton>
 #include <QStringBuilder>
 
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
 enum Columns : unsigned {
     Name = 0,
     Length = 1,
@@ -90,11 +95,6 @@ PathListModel::PathListModel(const AssemblyGraph &g,
                              const std::vector<DeBruijnNode*> &startNodes,
                              QObject *parent)
   : QAbstractTableModel(parent), graph(g) {
-    // Build a coverage map: which node is covered by which paths (used for filtering)
-    for (const auto &p : graph.m_deBruijnGraphPaths)
-        for (const auto *node : p.nodes())
-            m_coverageMap[node].insert(&p);
-
     refinePathOrder(startNodes);
 }
 
@@ -110,17 +110,26 @@ void PathListModel::sort(int column, Qt::SortOrder order) {
     switch (column) {
         default:
             return;
-        case Columns::Name:
-            std::sort(m_orderedPaths.begin(), m_orderedPaths.end(),
-                 [order](const auto &lhs, const auto &rhs) {
+        case Columns::Name: {
+            // Names are only kept in the path map, decode each of them once
+            std::vector<std::pair<std::string, uint32_t>> names;
+            names.reserve(m_orderedPaths.size());
+            for (uint32_t id : m_orderedPaths)
+                names.emplace_back(graph.m_pathIndex.name(id), id);
+            std::sort(names.begin(), names.end(),
+                 [&](const auto &lhs, const auto &rhs) {
                 return order == Qt::SortOrder::AscendingOrder ?
                        lhs.first < rhs.first : rhs.first < lhs.first;
             });
+            for (size_t i = 0; i < names.size(); ++i)
+                m_orderedPaths[i] = names[i].second;
             break;
+        }
         case Columns::Length:
             std::sort(m_orderedPaths.begin(), m_orderedPaths.end(),
-                      [order](const auto &lhs, const auto &rhs) {
-                          unsigned l = lhs.second->getLength(), r = rhs.second->getLength();
+                      [&](uint32_t lhs, uint32_t rhs) {
+                          unsigned l = graph.m_pathStore.length(graph.m_pathIndex.value(lhs)),
+                                   r = graph.m_pathStore.length(graph.m_pathIndex.value(rhs));
                           return order == Qt::SortOrder::AscendingOrder ?
                                  l < r : r < l;
                       });
@@ -158,19 +167,20 @@ QVariant PathListModel::data(const QModelIndex &index, int role) const {
         return {};
 
     if (role == Qt::DisplayRole) {
-        const auto &entry = m_orderedPaths.at(index.row());
+        uint32_t id = m_orderedPaths.at(index.row());
+        auto pathId = graph.m_pathIndex.value(id);
 
         switch (index.column()) {
             default:
                 return {};
             case Columns::Name:
-                return entry.first.c_str();
+                return QString::fromStdString(graph.m_pathIndex.name(id));
             case Columns::Length:
-                return entry.second->getLength();
+                return graph.m_pathStore.length(pathId);
             case Columns::NodePosition: {
                 if (m_node == nullptr)
                     return {};
-                auto pos = entry.second->getPosition(m_node);
+                auto pos = graph.getPath(pathId).getPosition(m_node);
                 QString positions;
                 for (size_t i = 0; i < pos.size(); ++i)
                     positions =
@@ -180,7 +190,7 @@ QVariant PathListModel::data(const QModelIndex &index, int role) const {
                 return positions;
             }
             case Columns::PathNodes:
-                return entry.second->getString(true);
+                return graph.getPath(pathId).getString(true);
         }
     }
 
@@ -195,26 +205,22 @@ void PathListModel::refinePathOrder(const std::vector<DeBruijnNode*> &nodes) {
 
     // No node: whole graph and all paths
     if (nodes.empty()) {
-        m_orderedPaths.reserve(graph.m_deBruijnGraphPaths.size());
-        for (auto it = graph.m_deBruijnGraphPaths.begin(); it != graph.m_deBruijnGraphPaths.end(); ++it)
-            m_orderedPaths.emplace_back(it.key(), &*it);
+        m_orderedPaths.resize(graph.m_pathIndex.size());
+        std::iota(m_orderedPaths.begin(), m_orderedPaths.end(), 0);
     } else {
-        phmap::flat_hash_set<const Path *> paths;
         if (nodes.size() == 1)
             m_node = nodes.front();
 
+        // Ids in the index are sorted, so merging them keeps the path map order
+        std::vector<uint32_t> ids;
         for (const auto *node: nodes) {
-            auto entry = m_coverageMap.find(node);
-            if (entry == m_coverageMap.end())
-                continue;
-
-            paths.insert(entry->second.begin(), entry->second.end());
+            auto paths = graph.m_pathIndex.pathsThrough(node);
+            ids.insert(ids.end(), paths.begin(), paths.end());
         }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-        // We have to iterate over all paths as names are stored as name in the map
-        for (auto it = graph.m_deBruijnGraphPaths.begin(); it != graph.m_deBruijnGraphPaths.end(); ++it)
-            if (paths.contains(&*it))
-                m_orderedPaths.emplace_back(it.key(), &*it);
+        m_orderedPaths = std::move(ids);
     }
 
     endResetModel();
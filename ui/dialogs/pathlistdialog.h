@@ -17,11 +17,10 @@
 
 #pragma once
 
-#include "parallel_hashmap/phmap.h"
-
 #include <QDialog>
 #include <QAbstractTableModel>
 
+#include <cstdint>
 #include <vector>
 
 namespace Ui {
@@ -49,8 +48,8 @@ public:
     void refinePathOrder(const std::vector<DeBruijnNode *> &nodes = {});
 private:
 
-    std::vector<std::pair<std::string, const Path*>> m_orderedPaths;
-    phmap::parallel_flat_hash_map<const DeBruijnNode*, phmap::flat_hash_set<const Path*>> m_coverageMap;
+    // Ids in AssemblyGraph::m_pathIndex
+    std::vector<uint32_t> m_orderedPaths;
     const DeBruijnNode *m_node = nullptr;
     const AssemblyGraph &graph;
 };
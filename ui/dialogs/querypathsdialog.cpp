@@ -64,6 +64,9 @@ QueryPathsDialog::QueryPathsDialog(Query *query, QWidget *parent) :
         queryDescription += " (" + formatIntForDisplay(3 * query->getLength()) + " bp)";
     else
         queryDescription += " bp";
+    if (query->isPathSearchTruncated())
+        queryDescription += "\nPath search stopped after " + formatIntForDisplay(Path::MaxPathSearchCandidates) +
+                            " candidate paths, some paths may be missing.";
     ui->queryLabel->setText(queryDescription);
 
     auto *proxyModel = new QSortFilterProxyModel(ui->tableView);
@@ -176,6 +176,11 @@ void SettingsDialog::loadOrSaveSettingsToOrFromWidgets(bool setWidgets, Settings
     doubleFunctionPointer(&settings->doubleModeNodeSeparation, ui->doubleModeNodeSeparationSpinBox, false);
     doubleFunctionPointer(&settings->nodeSegmentLength, ui->nodeSegmentLengthSpinBox, false);
     doubleFunctionPointer(&settings->componentSeparation, ui->componentSeparationSpinBox, false);
+    intFunctionPointer(&settings->loaderThreads, ui->loaderThreadsSpinBox);
+    checkBoxFunctionPointer(&settings->twoPassLoading, ui->twoPassLoadingCheckBox);
+    checkBoxFunctionPointer(&settings->incrementalLayout, ui->incrementalLayoutCheckBox);
+    intFunctionPointer(&settings->gafMinMapQ, ui->gafMinMapQSpinBox);
+    intFunctionPointer(&settings->gafMinAlignmentLength, ui->gafMinAlignmentLengthSpinBox);
     doubleFunctionPointer(&settings->depthEffectOnWidth, ui->depthEffectOnWidthSpinBox, true);
     doubleFunctionPointer(&settings->depthPower, ui->depthPowerSpinBox, false);
     doubleFunctionPointer(&settings->edgeWidth, ui->edgeWidthSpinBox, false);
@@ -228,6 +233,7 @@ void SettingsDialog::loadOrSaveSettingsToOrFromWidgets(bool setWidgets, Settings
     if (setWidgets)
     {
         ui->graphLayoutQualitySlider->setValue(settings->graphLayoutQuality);
+        ui->graphLayoutAlgorithmComboBox->setCurrentIndex(int(settings->graphLayoutAlgorithm));
         ui->linearLayoutOffRadioButton->setChecked(!settings->linearLayout);
         ui->linearLayoutOnRadioButton->setChecked(settings->linearLayout);
         ui->antialiasingOffRadioButton->setChecked(!settings->antialiasing);
@@ -250,6 +256,7 @@ void SettingsDialog::loadOrSaveSettingsToOrFromWidgets(bool setWidgets, Settings
     else
     {
         settings->graphLayoutQuality = ui->graphLayoutQualitySlider->value();
+        settings->graphLayoutAlgorithm = GraphLayoutAlgorithm(ui->graphLayoutAlgorithmComboBox->currentIndex());
         settings->linearLayout = ui->linearLayoutOnRadioButton->isChecked();
         settings->antialiasing = ui->antialiasingOnRadioButton->isChecked();
         settings->arrowheadsInSingleMode = ui->singleNodeArrowHeadsOnRadioButton->isChecked();
@@ -25,6 +25,11 @@
 #include <QPushButton>
 #include <QStringBuilder>
 
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
 enum Columns : unsigned {
     Sample = 0,
     HapIndex = 1,
@@ -94,11 +99,6 @@ WalkListModel::WalkListModel(const AssemblyGraph &g,
                              const std::vector<DeBruijnNode*> &startNodes,
                              QObject *parent)
   : QAbstractTableModel(parent), graph(g) {
-    // Build a coverage map: which node is covered by which walks (used for filtering)
-    for (const auto &w : graph.m_deBruijnGraphWalks)
-        for (const auto *node : w.walk.nodes())
-            m_coverageMap[node].insert(&w);
-
     refineWalkOrder(startNodes);
 }
 
@@ -114,18 +114,26 @@ void WalkListModel::sort(int column, Qt::SortOrder order) {
     switch (column) {
         default:
             return;
-        case Columns::Sequence:
-            std::sort(m_orderedWalks.begin(), m_orderedWalks.end(),
-                 [order](const auto &lhs, const auto &rhs) {
+        case Columns::Sequence: {
+            // Names are only kept in the walk map, decode each of them once
+            std::vector<std::pair<std::string, uint32_t>> names;
+            names.reserve(m_orderedWalks.size());
+            for (uint32_t id : m_orderedWalks)
+                names.emplace_back(graph.m_walkIndex.name(id), id);
+            std::sort(names.begin(), names.end(),
+                 [&](const auto &lhs, const auto &rhs) {
                 return order == Qt::SortOrder::AscendingOrder ?
                        lhs.first < rhs.first : rhs.first < lhs.first;
             });
+            for (size_t i = 0; i < names.size(); ++i)
+                m_orderedWalks[i] = names[i].second;
             break;
+        }
         case Columns::Sample:
             std::sort(m_orderedWalks.begin(), m_orderedWalks.end(),
-                 [order](const auto &lhs, const auto &rhs) {
-                const auto &lSample = lhs.second->sampleId;
-                const auto &rSample = rhs.second->sampleId;
+                 [&](uint32_t lhs, uint32_t rhs) {
+                const auto &lSample = graph.m_walkIndex.value(lhs).sampleId;
+                const auto &rSample = graph.m_walkIndex.value(rhs).sampleId;
 
                 return order == Qt::SortOrder::AscendingOrder ?
                        lSample < rSample : rSample < lSample;
@@ -133,24 +141,27 @@ void WalkListModel::sort(int column, Qt::SortOrder order) {
             break;
         case Columns::Length:
             std::sort(m_orderedWalks.begin(), m_orderedWalks.end(),
-                      [order](const auto &lhs, const auto &rhs) {
-                          unsigned l = lhs.second->walk.getLength(), r = rhs.second->walk.getLength();
+                      [&](uint32_t lhs, uint32_t rhs) {
+                          unsigned l = graph.m_walkStore.length(graph.m_walkIndex.value(lhs).pathId),
+                                   r = graph.m_walkStore.length(graph.m_walkIndex.value(rhs).pathId);
                           return order == Qt::SortOrder::AscendingOrder ?
                                  l < r : r < l;
                       });
             break;
         case Columns::SeqStart:
             std::sort(m_orderedWalks.begin(), m_orderedWalks.end(),
-                      [order](const auto &lhs, const auto &rhs) {
-                          unsigned l = lhs.second->seqStart, r = rhs.second->seqStart;
+                      [&](uint32_t lhs, uint32_t rhs) {
+                          unsigned l = graph.m_walkIndex.value(lhs).seqStart,
+                                   r = graph.m_walkIndex.value(rhs).seqStart;
                           return order == Qt::SortOrder::AscendingOrder ?
                                  l < r : r < l;
                       });
             break;
         case Columns::SeqEnd:
             std::sort(m_orderedWalks.begin(), m_orderedWalks.end(),
-                      [order](const auto &lhs, const auto &rhs) {
-                          unsigned l = lhs.second->seqEnd, r = rhs.second->seqEnd;
+                      [&](uint32_t lhs, uint32_t rhs) {
+                          unsigned l = graph.m_walkIndex.value(lhs).seqEnd,
+                                   r = graph.m_walkIndex.value(rhs).seqEnd;
                           return order == Qt::SortOrder::AscendingOrder ?
                                  l < r : r < l;
                       });
@@ -196,27 +207,28 @@ QVariant WalkListModel::data(const QModelIndex &index, int role) const {
         return {};
 
     if (role == Qt::DisplayRole) {
-        const auto &entry = m_orderedWalks.at(index.row());
+        uint32_t id = m_orderedWalks.at(index.row());
+        const Walk &walk = graph.m_walkIndex.value(id);
 
         switch (index.column()) {
             default:
                 return {};
             case Columns::Sequence:
-                return entry.first.c_str();
+                return QString::fromStdString(graph.m_walkIndex.name(id));
             case Columns::Sample:
-                return entry.second->sampleId.c_str();
+                return walk.sampleId.c_str();
             case Columns::HapIndex:
-                return entry.second->hapIndex;
+                return walk.hapIndex;
             case Columns::Length:
-                return entry.second->walk.getLength();
+                return graph.m_walkStore.length(walk.pathId);
             case Columns::SeqStart:
-                return entry.second->seqStart;
+                return walk.seqStart;
             case Columns::SeqEnd:
-                return entry.second->seqEnd;
+                return walk.seqEnd;
             case Columns::NodePosition: {
                 if (m_node == nullptr)
                     return {};
-                auto pos = entry.second->walk.getPosition(m_node);
+                auto pos = graph.getWalkPath(walk).getPosition(m_node);
                 QString positions;
                 for (size_t i = 0; i < pos.size(); ++i)
                     positions =
@@ -226,7 +238,7 @@ QVariant WalkListModel::data(const QModelIndex &index, int role) const {
                 return positions;
             }
             case Columns::WalkNodes:
-                return entry.second->walk.getString(true);
+                return graph.getWalkPath(walk).getString(true);
         }
     }
 
@@ -241,26 +253,22 @@ void WalkListModel::refineWalkOrder(const std::vector<DeBruijnNode*> &nodes) {
 
     // No node: whole graph and all walks
     if (nodes.empty()) {
-        m_orderedWalks.reserve(graph.m_deBruijnGraphWalks.size());
-        for (auto it = graph.m_deBruijnGraphWalks.begin(); it != graph.m_deBruijnGraphWalks.end(); ++it)
-            m_orderedWalks.emplace_back(it.key(), &*it);
+        m_orderedWalks.resize(graph.m_walkIndex.size());
+        std::iota(m_orderedWalks.begin(), m_orderedWalks.end(), 0);
     } else {
-        phmap::flat_hash_set<const Walk *> walks;
         if (nodes.size() == 1)
             m_node = nodes.front();
 
+        // Ids in the index are sorted, so merging them keeps the walk map order
+        std::vector<uint32_t> ids;
         for (const auto *node: nodes) {
-            auto entry = m_coverageMap.find(node);
-            if (entry == m_coverageMap.end())
-                continue;
-
-            walks.insert(entry->second.begin(), entry->second.end());
+            auto walks = graph.m_walkIndex.pathsThrough(node);
+            ids.insert(ids.end(), walks.begin(), walks.end());
         }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-        // We have to iterate over all walks as names are stored as name in the map
-        for (auto it = graph.m_deBruijnGraphWalks.begin(); it != graph.m_deBruijnGraphWalks.end(); ++it)
-            if (walks.contains(&*it))
-                m_orderedWalks.emplace_back(it.key(), &*it);
+        m_orderedWalks = std::move(ids);
     }
 
     endResetModel();
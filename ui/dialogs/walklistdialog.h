@@ -17,11 +17,10 @@
 
 #pragma once
 
-#include "parallel_hashmap/phmap.h"
-
 #include <QDialog>
 #include <QAbstractTableModel>
 
+#include <cstdint>
 #include <vector>
 
 namespace Ui {
@@ -49,8 +48,8 @@ public:
     void refineWalkOrder(const std::vector<DeBruijnNode *> &nodes = {});
 private:
 
-    std::vector<std::pair<std::string, const Walk*>> m_orderedWalks;
-    phmap::parallel_flat_hash_map<const DeBruijnNode*, phmap::flat_hash_set<const Walk*>> m_coverageMap;
+    // Ids in AssemblyGraph::m_walkIndex
+    std::vector<uint32_t> m_orderedWalks;
     const DeBruijnNode *m_node = nullptr;
     const AssemblyGraph &graph;
 };
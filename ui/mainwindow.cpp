@@ -342,6 +342,8 @@ void MainWindow::loadGraph(QString fullFileName) {
         return;
     }
     builder->treatJumpsAsLinks(g_settings->jumpsAsLinks);
+    builder->setThreads(g_settings->loaderThreads);
+    builder->useTwoPass(g_settings->twoPassLoading);
 
     resetScene();
     cleanUp();
@@ -381,8 +383,14 @@ void MainWindow::loadGraph(QString fullFileName) {
                 setUiState(GRAPH_LOADED);
                 setWindowTitle("BandageNG - " + fullFileName);
 
+                g_assemblyGraph->buildPathIndices();
                 g_assemblyGraph->determineGraphInfo();
+                g_settings->nodeColorer->graphChanged();
+                g_assemblyGraph->m_loadThroughput = builder->throughput();
                 displayGraphDetails();
+                if (g_assemblyGraph->m_loadThroughput > 0)
+                    ui->statusBar->showMessage(QString("Graph loaded at %1 MB/s")
+                                               .arg(g_assemblyGraph->m_loadThroughput, 0, 'f', 1));
                 g_memory->rememberedPath = QFileInfo(fullFileName).absolutePath();
                 g_memory->clearGraphSpecificMemory();
 
@@ -413,7 +421,7 @@ void MainWindow::loadGraph(QString fullFileName) {
 void MainWindow::loadGraphLayout(QString fullFileName) {
     if (fullFileName.isEmpty())
         fullFileName = QFileDialog::getOpenFileName(this, "Load Bandage layout", "",
-                                                    "Bandage layout (*.layout)");
+                                                    "Bandage layout (*.layout *.blayout)");
 
     if (fullFileName.isEmpty())
         return; // user clicked on cancel
@@ -437,23 +445,27 @@ void MainWindow::loadGraphLayout(QString fullFileName) {
 }
 
 void MainWindow::loadGraphPaths(QString fullFileName) {
-    QString selectedFilter = "GAF paths (*.gaf)";
+    QString selectedFilter = "GAF paths (*.gaf *.gaf.gz)";
     if (fullFileName.isEmpty())
         fullFileName = QFileDialog::getOpenFileName(this, "Load graph paths", "",
-                                                    "GAF paths (*.gaf);;GFA paths (*.gfa);;SPAligner TSV paths (*.tsv);;SPAdes paths (*.paths)",
+                                                    "GAF paths (*.gaf *.gaf.gz);;GFA paths (*.gfa);;SPAligner TSV paths (*.tsv);;SPAdes paths (*.paths)",
                                                     &selectedFilter);
 
     if (fullFileName.isEmpty())
         return; // user clicked on cancel
 
+    size_t skippedRecords = 0;
     try {
         if (selectedFilter == "GFA paths (*.gfa)")
             io::loadGFAPaths(*g_assemblyGraph, fullFileName);
         else if (selectedFilter == "SPAligner TSV paths (*.tsv)")
             io::loadSPAlignerPaths(*g_assemblyGraph, fullFileName);
-        else if (selectedFilter == "GAF paths (*.gaf)")
-            io::loadGAFPaths(*g_assemblyGraph, fullFileName);
-        else
+        else if (selectedFilter == "GAF paths (*.gaf *.gaf.gz)") {
+            io::GAFFilter filter;
+            filter.minMapQ = unsigned(g_settings->gafMinMapQ);
+            filter.minAlignmentLength = size_t(g_settings->gafMinAlignmentLength);
+            io::loadGAFPaths(*g_assemblyGraph, fullFileName, filter, &skippedRecords);
+        } else
             io::loadSPAdesPaths(*g_assemblyGraph, fullFileName);
     } catch (std::exception &e) {
         QString errorTitle = "Error loading graph paths";
@@ -470,6 +482,13 @@ void MainWindow::loadGraphPaths(QString fullFileName) {
     displayGraphDetails();
     setupPathSelectionLineEdit(ui->pathSelectionLineEdit);
     setupPathSelectionLineEdit(ui->pathSelectionLineEdit2);
+
+    if (skippedRecords)
+        QMessageBox::warning(this, "Paths skipped",
+                             formatIntForDisplay(skippedRecords) + " alignment records of:\n"
+                             + fullFileName + "\n"
+                             "were skipped because they refer to nodes that are not in the graph "
+                             "or do not pass the GAF mapping quality / alignment length filters.");
 }
 
 void MainWindow::loadGraphLinks(QString fullFileName) {
@@ -648,7 +667,7 @@ void MainWindow::getSelectedNodeInfo(int & selectedNodeCount, QString & selected
 
     if (selectedNodeCount == 1) {
         // FIXME: Hack!
-        selectedNodeDepthText += " GC: " + formatDoubleForDisplay(100 * selectedNodes[0]->getGC(), 1) + "%";
+        selectedNodeDepthText += " GC: " + formatDoubleForDisplay(100 * g_assemblyGraph->m_nodeMetrics.get(selectedNodes[0]).gc, 1) + "%";
 
         auto tags = g_assemblyGraph->m_nodeTags.find(selectedNodes.front());
         if (tags != g_assemblyGraph->m_nodeTags.end()) {
@@ -1022,16 +1041,40 @@ void MainWindow::drawGraph() {
         return;
     }
 
+    // Remember where the currently drawn nodes are, so they stay in place
+    // when the scope changes
+    std::unique_ptr<GraphLayout> seedLayout;
+    if (g_settings->incrementalLayout)
+        seedLayout = std::make_unique<GraphLayout>(layout::fromGraph(*g_assemblyGraph));
+
     resetScene();
     g_assemblyGraph->resetNodes();
     g_assemblyGraph->markNodesToDraw(scope, startingNodes);
-    layoutGraph();
+
+    // Redrawing the same nodes is a request for a fresh layout, so positions
+    // are only reused when the drawn scope changed
+    if (seedLayout) {
+        size_t drawnNodes = 0;
+        bool sameNodes = true;
+        for (const auto *node : g_assemblyGraph->m_deBruijnGraphNodes) {
+            if (node->isNotDrawn())
+                continue;
+            drawnNodes += 1;
+            if (!seedLayout->contains(node)) {
+                sameNodes = false;
+                break;
+            }
+        }
+        if (sameNodes && drawnNodes == seedLayout->size())
+            seedLayout.reset();
+    }
+
+    layoutGraph(std::move(seedLayout));
 }
 
 
 void MainWindow::graphLayoutFinished(const GraphLayout &layout) {
     m_scene->addGraphicsItemsToScene(*g_assemblyGraph, layout);
-    m_scene->setSceneRectangle();
     zoomToFitScene();
 
     double averageNodeWidth = g_settings->averageNodeWidth / pow(g_absoluteZoom, 0.75);
@@ -1074,7 +1117,7 @@ std::vector<DeBruijnNode *> MainWindow::getNodesFromLineEdit(QLineEdit * lineEdi
 
 
 
-void MainWindow::layoutGraph()
+void MainWindow::layoutGraph(std::unique_ptr<GraphLayout> seedLayout)
 {
     //The actual layout is done in a different thread so the UI will stay responsive.
     auto *progress = new MyProgressDialog(this, "Laying out graph...", true, "Cancel layout", "Cancelling layout...",
@@ -1092,11 +1135,16 @@ void MainWindow::layoutGraph()
     progress->show();
 
     double aspectRatio = double(g_graphicsView->width()) / g_graphicsView->height();
-    auto *graphLayoutWorker = new GraphLayoutWorker(g_settings->graphLayoutQuality,
+    auto *graphLayoutWorker = new GraphLayoutWorker(g_settings->graphLayoutAlgorithm,
+                                                    g_settings->graphLayoutQuality,
                                                     g_settings->linearLayout,
                                                     g_settings->componentSeparation, aspectRatio);
+    if (seedLayout && seedLayout->size() > 0)
+        graphLayoutWorker->setSeedLayout(std::move(*seedLayout));
 
     connect(progress, SIGNAL(halt()), graphLayoutWorker, SLOT(cancelLayout()));
+    progress->setMaxValue(100);
+    connect(graphLayoutWorker, SIGNAL(layoutProgress(int)), progress, SLOT(setValue(int)));
 
     auto *watcher = new QFutureWatcher<GraphLayout>;
 
@@ -1606,7 +1654,7 @@ void MainWindow::setTextDisplaySettings()
     g_settings->displayNodeCsvDataCol = ui->csvComboBox->currentIndex();
     g_settings->textOutline = ui->textOutlineCheckBox->isChecked();
 
-    g_graphicsView->viewport()->update();
+    g_graphicsView->updateViewportUpdateMode();
 }
 
 
@@ -1808,7 +1856,7 @@ void MainWindow::selectPathNodes() {
         return;
     }
 
-    const Path &p = *pathIt;
+    Path p = g_assemblyGraph->getPath(*pathIt);
 
     QString posText = ui->pathSelectionPositionLineEdit->text();
     if (posText.isEmpty()) {
@@ -1855,11 +1903,11 @@ void MainWindow::selectWalkNodes() {
         return;
     }
 
-    const auto &p = *walkIt;
+    Path p = g_assemblyGraph->getWalkPath(*walkIt);
 
     QString posText = ui->walkSelectionPositionLineEdit->text();
     if (posText.isEmpty()) {
-        for (auto *node : p.walk.nodes())
+        for (auto *node : p.nodes())
             nodesToSelect.push_back(node);
     } else {
         bool ok = true;
@@ -1884,7 +1932,7 @@ void MainWindow::selectWalkNodes() {
             }
         }
 
-        nodesToSelect = p.walk.getNodesAt(startPos, endPos);
+        nodesToSelect = p.getNodesAt(startPos, endPos);
     }
 
     doSelectNodes(nodesToSelect, nodesNotInGraph, ui->walkSelectionRecolorRadioButton->isChecked());
@@ -2098,15 +2146,16 @@ void MainWindow::selectNodesWithBlastHits() {
     bool atLeastOneNodeHasBlastHits = false;
     bool atLeastOneNodeSelected = false;
 
-    for (auto &[node, annotations] : blastHitsGroup->annotationMap) {
+    const auto &annotations = blastHitsGroup->annotations;
+    for (const DeBruijnNode *node : annotations.nodes()) {
 
         bool nodeHasBlastHits;
 
         //If we're in double mode, only select a node if it has a BLAST hit itself.
-        nodeHasBlastHits = !annotations.empty();
+        nodeHasBlastHits = annotations.hasFeatures(node);
         if (!g_settings->doubleMode)
             //In single mode, select a node if it or its reverse complement has a BLAST hit.
-            nodeHasBlastHits = nodeHasBlastHits || !blastHitsGroup->getAnnotations(node->getReverseComplement()).empty();
+            nodeHasBlastHits = nodeHasBlastHits || annotations.hasFeatures(node->getReverseComplement());
 
         if (nodeHasBlastHits)
             atLeastOneNodeHasBlastHits = true;
@@ -2538,6 +2587,7 @@ void MainWindow::removeSelection()
     cleanUpAllBlast();
 
     resetNodeContiguityStatus();
+    g_settings->nodeColorer->graphChanged();
     resetAllNodeColours();
 }
 
@@ -2573,6 +2623,7 @@ void MainWindow::duplicateSelectedNodes()
     // stuff, as they may no longer apply.
     cleanUpAllBlast();
     resetNodeContiguityStatus();
+    g_settings->nodeColorer->graphChanged();
     resetAllNodeColours();
 }
 
@@ -2611,6 +2662,7 @@ void MainWindow::mergeSelectedNodes() {
     // stuff, as they may no longer apply.
     cleanUpAllBlast();
     resetNodeContiguityStatus();
+    g_settings->nodeColorer->graphChanged();
     resetAllNodeColours();
 }
 
@@ -2644,6 +2696,7 @@ void MainWindow::mergeAllPossible()
         //stuff, as they may no longer apply.
         cleanUpAllBlast();
         resetNodeContiguityStatus();
+        g_settings->nodeColorer->graphChanged();
         resetAllNodeColours();
     }
     else
@@ -2720,17 +2773,28 @@ void MainWindow::exportGraphLayout() {
     QString filter = "Bandage layout (*.layout)";
     QString fullFileName = QFileDialog::getSaveFileName(this, "Export graph layout",
                                                         "",
-                                                        "Bandage layout (*.layout);;TSV (*.tsv)",
+                                                        "Bandage layout (*.layout);;Bandage binary layout (*.blayout);;TSV (*.tsv)",
                                                         &filter);
 
     if (fullFileName.isEmpty())
         return;
 
     bool isTSV = filter == "TSV (*.tsv)";
+    bool isBinary = !isTSV &&
+                    (filter == "Bandage binary layout (*.blayout)" || layout::io::isBinary(fullFileName));
+    // Loading picks the reader from the extension, so binary layouts must end in .blayout
+    if (isBinary && !layout::io::isBinary(fullFileName)) {
+        if (fullFileName.endsWith(".layout", Qt::CaseInsensitive))
+            fullFileName.chop(7); // ".layout"
+        fullFileName += ".blayout";
+    }
+
     GraphLayout layout = layout::fromGraph(*g_assemblyGraph,
                                            /* simplified */ isTSV);
     if (isTSV)
         layout::io::saveTSV(fullFileName, layout);
+    else if (isBinary)
+        layout::io::saveBinary(fullFileName, layout);
     else
         layout::io::save(fullFileName, layout);
 }
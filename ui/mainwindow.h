@@ -36,6 +36,8 @@
 #include <QRectF>
 #include <QThread>
 
+#include <memory>
+
 Q_MOC_INCLUDE("graph/debruijnnode.h")
 
 class GraphicsViewZoom;
@@ -79,7 +81,7 @@ private:
     void clearGraphDetails();
     void resetScene();
     void resetAllNodeColours();
-    void layoutGraph();
+    void layoutGraph(std::unique_ptr<GraphLayout> seedLayout = nullptr);
     void zoomToFitRect(QRectF rect);
     void setZoomSpinBoxStep();
     void getSelectedNodeInfo(int & selectedNodeCount, QString & selectedNodeCountText,